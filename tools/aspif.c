@@ -0,0 +1,1068 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+/*
+ * Programs in the aspif format: rules, minimize statements, output
+ * directives, externals, and assumptions are mapped onto the rule types
+ * and symbol tables of liblp (and back) without going through SMODELS
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+#include "version.h"
+#include "symbol.h"
+#include "atom.h"
+#include "rule.h"
+#include "io.h"
+#include "aspif.h"
+
+void _version_aspif_h()
+{
+  _version(_ASPIF_H_RCSFILE, _ASPIF_H_DATE, _ASPIF_H_REVISION);
+}
+
+void _version_aspif_c()
+{
+  _version_aspif_h();
+  _version("$RCSfile: aspif.c,v $",
+	   "$Date: 2026/10/18 20:00:00 $",
+	   "$Revision: 1.1 $");
+}
+
+/* --------------------------- Lexical analysis ---------------------------- */
+
+int is_aspif(FILE *in)
+{
+  int c = getc(in);
+
+  if(c != EOF)
+    ungetc(c, in);
+
+  return (c == 'a');
+}
+
+/* Atoms of the program are below AUX_BASE (see new_aux_atom) */
+
+#define AUX_BASE (INT_MAX/2)
+
+/* The first error is recorded and reading stops at the next statement;
+   until then, numbers read are zero (see read_aspif) */
+
+void aspif_error(ASPIFIN *s, char *msg)
+{
+  if(!s->error[0])
+    snprintf(s->error, ASPIF_ERROR_SIZE, "%s", msg);
+
+  return;
+}
+
+/* Read an integer and the single separator following it */
+
+int aspif_int(ASPIFIN *s)
+{
+  FILE *in = s->in;
+  int c = 0;
+  int negative = 0;
+  int value = 0;
+
+  if(s->error[0])
+    return 0;
+
+  c = getc(in);
+  while(c == ' ' || c == '\n' || c == '\r' || c == '\t')
+    c = getc(in);
+
+  if(c == '-') {
+    negative = -1;
+    c = getc(in);
+  }
+
+  if(c < '0' || c > '9') {
+    aspif_error(s, "number expected");
+    return 0;
+  }
+
+  while(c >= '0' && c <= '9') {
+    if(value > (INT_MAX-(c-'0'))/10) {
+      aspif_error(s, "number out of range");
+      return 0;
+    }
+    value = 10*value + (c-'0');
+    c = getc(in);
+  }
+
+  return negative ? -value : value;
+}
+
+/* Counts of literals and lengths of names */
+
+int aspif_count(ASPIFIN *s)
+{
+  int cnt = aspif_int(s);
+
+  if(cnt < 0) {
+    aspif_error(s, "negative count");
+    return 0;
+  }
+
+  return cnt;
+}
+
+/* Read literals (and weights) while keeping track of the largest atom */
+
+int *aspif_lits(ASPIFIN *s, int cnt, int **weights)
+{
+  int *lits = (int *)malloc((cnt+1)*sizeof(int));
+  int i = 0;
+
+  if(weights)
+    *weights = (int *)malloc((cnt+1)*sizeof(int));
+
+  if(!lits || (weights && !*weights)) {
+    aspif_error(s, "cannot allocate memory");
+    cnt = 0;
+  }
+
+  for(i=0; i<cnt; i++) {
+    int lit = aspif_int(s);
+
+    if(s->error[0])
+      break;
+    if(lit == 0 || lit >= AUX_BASE || -lit >= AUX_BASE) {
+      aspif_error(s, lit ? "atom out of range" : "zero literal");
+      break;
+    }
+    if(lit > s->max_atom)
+      s->max_atom = lit;
+    if(-lit > s->max_atom)
+      s->max_atom = -lit;
+
+    lits[i] = lit;
+    if(weights)
+      (*weights)[i] = aspif_int(s);
+  }
+
+  return lits;
+}
+
+void skip_line(ASPIFIN *s)
+{
+  int c = 0;
+
+  while((c = getc(s->in)) != EOF && c != '\n')
+    ;
+
+  return;
+}
+
+/* ---------------------------- Building rules ----------------------------- */
+
+/*
+ * New atoms cannot be numbered before the largest atom of the program
+ * is known; until then they are numbered from AUX_BASE onwards
+ */
+
+int new_aux_atom(ASPIFIN *s)
+{
+  return AUX_BASE + (s->aux_cnt)++;
+}
+
+void add_rule(ASPIFIN *s, RULE *rule)
+{
+  rule->next = NULL;
+
+  if(s->last)
+    s->last->next = rule;
+  else
+    s->first = rule;
+  s->last = rule;
+
+  return;
+}
+
+/* Split literals into negative and positive atoms (weights in that order) */
+
+void split_lits(int cnt, int *lits, int *weights,
+		int *pos_cnt, int **pos, int *neg_cnt, int **neg, int **ws)
+{
+  int i = 0, p = 0, n = 0;
+
+  *pos_cnt = *neg_cnt = 0;
+  for(i=0; i<cnt; i++)
+    if(lits[i] < 0)
+      (*neg_cnt)++;
+    else
+      (*pos_cnt)++;
+
+  *pos = *pos_cnt ? (int *)malloc((*pos_cnt)*sizeof(int)) : NULL;
+  *neg = *neg_cnt ? (int *)malloc((*neg_cnt)*sizeof(int)) : NULL;
+  if(ws)
+    *ws = (int *)malloc((cnt+1)*sizeof(int));
+
+  for(i=0; i<cnt; i++)
+    if(lits[i] < 0) {
+      if(ws)
+	(*ws)[n] = weights[i];
+      (*neg)[n++] = -lits[i];
+    } else {
+      if(ws)
+	(*ws)[*neg_cnt+p] = weights[i];
+      (*pos)[p++] = lits[i];
+    }
+
+  return;
+}
+
+RULE *new_rule(int type, int head_cnt, int *heads, int bound,
+	       int cnt, int *lits, int *weights)
+{
+  RULE *rule = (RULE *)malloc(sizeof(RULE));
+
+  rule->type = type;
+  rule->next = NULL;
+
+  switch(type) {
+  case TYPE_BASIC:
+    { BASIC_RULE *basic = (BASIC_RULE *)malloc(sizeof(BASIC_RULE));
+
+      basic->head = heads[0];
+      split_lits(cnt, lits, NULL, &basic->pos_cnt, &basic->pos,
+		 &basic->neg_cnt, &basic->neg, NULL);
+      rule->data.basic = basic;
+    }
+    break;
+
+  case TYPE_CONSTRAINT:
+    { CONSTRAINT_RULE *constraint =
+	(CONSTRAINT_RULE *)malloc(sizeof(CONSTRAINT_RULE));
+
+      constraint->head = heads[0];
+      constraint->bound = bound;
+      split_lits(cnt, lits, NULL, &constraint->pos_cnt, &constraint->pos,
+		 &constraint->neg_cnt, &constraint->neg, NULL);
+      rule->data.constraint = constraint;
+    }
+    break;
+
+  case TYPE_CHOICE:
+    { CHOICE_RULE *choice = (CHOICE_RULE *)malloc(sizeof(CHOICE_RULE));
+
+      choice->head_cnt = head_cnt;
+      choice->head = heads;
+      split_lits(cnt, lits, NULL, &choice->pos_cnt, &choice->pos,
+		 &choice->neg_cnt, &choice->neg, NULL);
+      rule->data.choice = choice;
+    }
+    break;
+
+  case TYPE_WEIGHT:
+    { WEIGHT_RULE *weight = (WEIGHT_RULE *)malloc(sizeof(WEIGHT_RULE));
+
+      weight->head = heads[0];
+      weight->bound = bound;
+      split_lits(cnt, lits, weights, &weight->pos_cnt, &weight->pos,
+		 &weight->neg_cnt, &weight->neg, &weight->weight);
+      rule->data.weight = weight;
+    }
+    break;
+
+  case TYPE_OPTIMIZE:
+    { OPTIMIZE_RULE *optimize = (OPTIMIZE_RULE *)malloc(sizeof(OPTIMIZE_RULE));
+
+      split_lits(cnt, lits, weights, &optimize->pos_cnt, &optimize->pos,
+		 &optimize->neg_cnt, &optimize->neg, &optimize->weight);
+      rule->data.optimize = optimize;
+    }
+    break;
+
+  case TYPE_DISJUNCTIVE:
+    { DISJUNCTIVE_RULE *disjunctive =
+	(DISJUNCTIVE_RULE *)malloc(sizeof(DISJUNCTIVE_RULE));
+
+      disjunctive->head_cnt = head_cnt;
+      disjunctive->head = heads;
+      split_lits(cnt, lits, NULL, &disjunctive->pos_cnt, &disjunctive->pos,
+		 &disjunctive->neg_cnt, &disjunctive->neg, NULL);
+      rule->data.disjunctive = disjunctive;
+    }
+    break;
+  }
+
+  return rule;
+}
+
+/*
+ * normalize_weights -- Make weights positive by complementing literals
+ * (the bound is adjusted accordingly) and drop literals of weight zero
+ */
+
+int normalize_weights(int cnt, int *lits, int *weights, int *bound)
+{
+  int i = 0, j = 0;
+
+  for(i=0; i<cnt; i++) {
+    if(weights[i] < 0) {
+      lits[i] = -lits[i];
+      weights[i] = -weights[i];
+      if(bound)
+	*bound += weights[i];
+    }
+    if(weights[i] > 0) {
+      lits[j] = lits[i];
+      weights[j++] = weights[i];
+    }
+  }
+
+  return j;
+}
+
+/*
+ * add_body_rule -- Add a rule with a single head atom and a weight body
+ * (a constraint rule if all weights are one; a basic rule if trivial)
+ */
+
+void add_body_rule(ASPIFIN *s, int head, int bound,
+		   int cnt, int *lits, int *weights)
+{
+  int unit = -1;
+  int i = 0;
+
+  cnt = normalize_weights(cnt, lits, weights, &bound);
+
+  for(i=0; i<cnt; i++)
+    if(weights[i] != 1)
+      unit = 0;
+
+  if(bound <= 0)
+    add_rule(s, new_rule(TYPE_BASIC, 1, &head, 0, 0, lits, NULL));
+  else if(unit)
+    add_rule(s, new_rule(TYPE_CONSTRAINT, 1, &head, bound, cnt, lits, NULL));
+  else
+    add_rule(s, new_rule(TYPE_WEIGHT, 1, &head, bound, cnt, lits, weights));
+
+  return;
+}
+
+/* --------------------------- Atoms and names ----------------------------- */
+
+void set_status(ASPIFIN *s, int atom, int status)
+{
+  if(atom >= s->status_size) {
+    int size = s->status_size;
+
+    while(atom >= size)
+      size *= 2;
+    s->statuses = (int *)realloc(s->statuses, size*sizeof(int));
+    memset(&s->statuses[s->status_size], 0,
+	   (size-s->status_size)*sizeof(int));
+    s->status_size = size;
+  }
+
+  s->statuses[atom] |= status;
+
+  return;
+}
+
+int get_status(ASPIFIN *s, int atom)
+{
+  return atom < s->status_size ? s->statuses[atom] : 0;
+}
+
+unsigned int hash_name(char *name)
+{
+  unsigned int hash = 2166136261u;
+
+  while(*name)
+    hash = (hash ^ (unsigned char)*name++) * 16777619u;
+
+  return hash;
+}
+
+/* Find the index of a name (or the free slot for it) */
+
+int *find_name_slot(ASPIFIN *s, char *name)
+{
+  unsigned int i = hash_name(name) & (s->hash_size-1);
+
+  while(s->hash[i] && strcmp(s->names[s->hash[i]-1], name) != 0)
+    i = (i+1) & (s->hash_size-1);
+
+  return &s->hash[i];
+}
+
+void add_name(ASPIFIN *s, char *name, int atom)
+{
+  int i = 0;
+
+  if(s->name_cnt == s->name_size) {
+    s->name_size *= 2;
+    s->names = (char **)realloc(s->names, s->name_size*sizeof(char *));
+    s->named = (int *)realloc(s->named, s->name_size*sizeof(int));
+  }
+
+  s->names[s->name_cnt] = name;
+  s->named[s->name_cnt] = atom;
+  *find_name_slot(s, name) = ++(s->name_cnt);
+
+  if(2*s->name_cnt > s->hash_size) {   /* Rehash */
+    free(s->hash);
+    s->hash_size *= 2;
+    s->hash = (int *)calloc(s->hash_size, sizeof(int));
+    for(i=0; i<s->name_cnt; i++)
+      *find_name_slot(s, s->names[i]) = i+1;
+  }
+
+  return;
+}
+
+/*
+ * show -- An output directive: an atom having the name is made true
+ * exactly when some of the conditions given for the name is satisfied
+ */
+
+void show(ASPIFIN *s, char *name, int cnt, int *lits)
+{
+  int *slot = find_name_slot(s, name);
+  int atom = 0;
+
+  if(*slot) {
+    int k = *slot-1;
+
+    free(name);
+    atom = s->named[k];
+
+    if(atom < AUX_BASE) {  /* Let a new atom stand for the name */
+      int aux = new_aux_atom(s);
+
+      add_rule(s, new_rule(TYPE_BASIC, 1, &aux, 0, 1, &atom, NULL));
+      s->statuses[atom] &= ~MARK_VISIBLE;
+      s->named[k] = atom = aux;
+    }
+
+  } else if(cnt == 1 && lits[0] > 0 &&
+	    !(get_status(s, lits[0]) & MARK_VISIBLE)) {
+    set_status(s, lits[0], MARK_VISIBLE);
+    add_name(s, name, lits[0]);
+    return;
+
+  } else {
+    atom = new_aux_atom(s);
+    add_name(s, name, atom);
+  }
+
+  add_rule(s, new_rule(TYPE_BASIC, 1, &atom, 0, cnt, lits, NULL));
+
+  return;
+}
+
+/* --------------------------- Reading statements -------------------------- */
+
+void read_aspif_rule(ASPIFIN *s)
+{
+  int choice = aspif_int(s);
+  int head_cnt = aspif_count(s);
+  int *heads = aspif_lits(s, head_cnt, NULL);
+  int weighted = aspif_int(s);
+  int bound = weighted ? aspif_int(s) : 0;
+  int cnt = aspif_count(s);
+  int *weights = NULL;
+  int *lits = aspif_lits(s, cnt, weighted ? &weights : NULL);
+  int i = 0;
+
+  for(i=0; i<head_cnt && !s->error[0]; i++)
+    if(heads[i] < 0)
+      aspif_error(s, "negative head atom");
+
+  if(s->error[0]) {
+    free(heads);
+
+  } else if(choice && head_cnt == 0) {   /* Nothing to choose */
+    free(heads);
+
+  } else if(!choice && head_cnt <= 1) {
+    if(head_cnt == 0) {     /* An integrity constraint */
+      if(!s->false_atom)
+	s->false_atom = new_aux_atom(s);
+      heads[0] = s->false_atom;
+    }
+    if(weighted)
+      add_body_rule(s, heads[0], bound, cnt, lits, weights);
+    else
+      add_rule(s, new_rule(TYPE_BASIC, 1, heads, 0, cnt, lits, NULL));
+    free(heads);
+
+  } else {
+    if(weighted) {          /* A new atom stands for the body */
+      int body = new_aux_atom(s);
+
+      add_body_rule(s, body, bound, cnt, lits, weights);
+      lits[0] = body;
+      cnt = 1;
+    }
+    add_rule(s, new_rule(choice ? TYPE_CHOICE : TYPE_DISJUNCTIVE,
+			 head_cnt, heads, 0, cnt, lits, NULL));
+  }
+
+  free(lits);
+  if(weights)
+    free(weights);
+
+  return;
+}
+
+void read_aspif_minimize(ASPIFIN *s)
+{
+  ASPIFMIN *min = NULL;
+
+  if(s->min_cnt == s->min_size) {
+    s->min_size = s->min_size ? 2*s->min_size : 4;
+    s->mins = (ASPIFMIN *)realloc(s->mins, s->min_size*sizeof(ASPIFMIN));
+  }
+
+  min = &s->mins[s->min_cnt];
+  min->number = s->min_cnt++;
+  min->priority = aspif_int(s);
+  min->cnt = aspif_count(s);
+  min->lits = aspif_lits(s, min->cnt, &min->weights);
+
+  if(s->error[0])
+    min->cnt = 0;
+
+  /* Complementing literals shifts all costs by the same constant */
+
+  min->cnt = normalize_weights(min->cnt, min->lits, min->weights, NULL);
+
+  return;
+}
+
+void read_aspif_output(ASPIFIN *s)
+{
+  FILE *in = s->in;
+  int len = aspif_count(s);
+  char *name = (char *)malloc(len+1);
+  int cnt = 0;
+  int *lits = NULL;
+
+  if(!name)
+    aspif_error(s, "cannot allocate memory");
+  else if(!s->error[0] && fread(name, 1, len, in) != len)
+    aspif_error(s, "truncated output directive");
+
+  cnt = aspif_count(s);
+  lits = aspif_lits(s, cnt, NULL);
+
+  if(s->error[0]) {
+    free(name);
+    free(lits);
+    return;
+  }
+
+  name[len] = '\0';
+  show(s, name, cnt, lits);
+
+  free(lits);
+
+  return;
+}
+
+void read_aspif_external(ASPIFIN *s)
+{
+  int atom = aspif_int(s);
+  int value = aspif_int(s);
+
+  if(!s->error[0] && (atom <= 0 || atom >= AUX_BASE))
+    aspif_error(s, "atom out of range");
+  if(s->error[0])
+    return;
+
+  if(atom > s->max_atom)
+    s->max_atom = atom;
+
+  /* Free (0) and true (1) externals are input atoms; false (2) ones
+     and released (3) ones are false by default */
+
+  if(value == 0)
+    set_status(s, atom, MARK_INPUT);
+  else if(value == 1)
+    set_status(s, atom, MARK_INPUT|MARK_TRUE);
+
+  return;
+}
+
+void read_aspif_assumptions(ASPIFIN *s)
+{
+  int cnt = aspif_count(s);
+  int *lits = aspif_lits(s, cnt, NULL);
+  int i = 0;
+
+  for(i=0; i<cnt && !s->error[0]; i++)
+    if(lits[i] > 0)
+      set_status(s, lits[i], MARK_TRUE);
+    else
+      set_status(s, -lits[i], MARK_FALSE);
+
+  free(lits);
+
+  return;
+}
+
+/* --------------------- Finishing the program and table ------------------- */
+
+int compare_priorities(const void *m1, const void *m2)
+{
+  const ASPIFMIN *min1 = (const ASPIFMIN *)m1;
+  const ASPIFMIN *min2 = (const ASPIFMIN *)m2;
+
+  if(min1->priority != min2->priority)
+    return min1->priority < min2->priority ? -1 : 1;
+
+  return min1->number - min2->number;
+}
+
+/*
+ * add_minimize_rules -- Merge minimize statements having the same
+ * priority; the one with the highest priority comes last as in SMODELS
+ */
+
+void add_minimize_rules(ASPIFIN *s)
+{
+  int i = 0, j = 0, k = 0;
+
+  qsort(s->mins, s->min_cnt, sizeof(ASPIFMIN), compare_priorities);
+
+  for(i=0; i<s->min_cnt; i = j) {
+    int cnt = 0;
+    int *lits = NULL;
+    int *weights = NULL;
+
+    for(j=i; j<s->min_cnt && s->mins[j].priority == s->mins[i].priority; j++)
+      cnt += s->mins[j].cnt;
+
+    lits = (int *)malloc((cnt+1)*sizeof(int));
+    weights = (int *)malloc((cnt+1)*sizeof(int));
+
+    for(cnt=0, k=i; k<j; k++) {
+      memcpy(&lits[cnt], s->mins[k].lits, s->mins[k].cnt*sizeof(int));
+      memcpy(&weights[cnt], s->mins[k].weights, s->mins[k].cnt*sizeof(int));
+      cnt += s->mins[k].cnt;
+      free(s->mins[k].lits);
+      free(s->mins[k].weights);
+    }
+
+    add_rule(s, new_rule(TYPE_OPTIMIZE, 0, NULL, 0, cnt, lits, weights));
+
+    free(lits);
+    free(weights);
+  }
+
+  if(s->mins)
+    free(s->mins);
+
+  return;
+}
+
+/* New atoms get numbers after the largest atom of the program */
+
+void renumber_list(int cnt, int *atoms, int max_atom)
+{
+  int i = 0;
+
+  for(i=0; i<cnt; i++)
+    if(atoms[i] >= AUX_BASE)
+      atoms[i] = max_atom+1+(atoms[i]-AUX_BASE);
+
+  return;
+}
+
+void renumber_aux_atoms(RULE *program, int max_atom)
+{
+  RULE *rule = NULL;
+
+  for(rule = program; rule; rule = rule->next) {
+    switch(rule->type) {
+    case TYPE_BASIC:
+      renumber_list(1, &rule->data.basic->head, max_atom);
+      break;
+    case TYPE_CONSTRAINT:
+      renumber_list(1, &rule->data.constraint->head, max_atom);
+      break;
+    case TYPE_WEIGHT:
+      renumber_list(1, &rule->data.weight->head, max_atom);
+      break;
+    }
+    renumber_list(get_pos_cnt(rule), get_pos(rule), max_atom);
+  }
+
+  return;
+}
+
+void free_aspif_input(ASPIFIN *s)
+{
+  int i = 0;
+
+  for(i=0; i<s->min_cnt; i++) {
+    free(s->mins[i].lits);
+    free(s->mins[i].weights);
+  }
+  if(s->mins)
+    free(s->mins);
+
+  for(i=0; i<s->name_cnt; i++)
+    free(s->names[i]);
+
+  free(s->names);
+  free(s->named);
+  free(s->hash);
+  free(s->statuses);
+
+  return;
+}
+
+/*
+ * read_aspif -- Read a program in the aspif format (the header included)
+ * and form its symbol table where names of atoms are the strings of
+ * output directives; integrity constraints get a new atom as their head
+ * which is set false by the compute statement. On errors, *table is set
+ * to NULL and the message is copied to error (if not NULL) which must
+ * have room for ASPIF_ERROR_SIZE characters.
+ */
+
+RULE *read_aspif(FILE *in, ATAB **table, char *error)
+{
+  ASPIFIN s;
+  char header[256];
+  int len = 0;
+  int size = 0;
+  int type = 0;
+  int i = 0;
+
+  memset(&s, 0, sizeof(ASPIFIN));
+  s.in = in;
+  s.name_size = 16;
+  s.names = (char **)malloc(s.name_size*sizeof(char *));
+  s.named = (int *)malloc(s.name_size*sizeof(int));
+  s.hash_size = 64;
+  s.hash = (int *)calloc(s.hash_size, sizeof(int));
+  s.status_size = 1024;
+  s.statuses = (int *)calloc(s.status_size, sizeof(int));
+
+  /* The header: asp 1 <minor> <revision> <tags> */
+
+  while((i = getc(in)) != EOF && i != '\n')
+    if(len < sizeof(header)-1)
+      header[len++] = i;
+  header[len] = '\0';
+
+  if(strncmp(header, "asp 1 ", 6) != 0)
+    aspif_error(&s, "header asp 1 expected");
+  if(strstr(header, "incremental"))
+    aspif_error(&s, "incremental programs are not supported");
+
+  while(!s.error[0] && (type = aspif_int(&s)) != 0) {
+    switch(type) {
+    case 1:
+      read_aspif_rule(&s);
+      break;
+    case 2:
+      read_aspif_minimize(&s);
+      break;
+    case 4:
+      read_aspif_output(&s);
+      break;
+    case 5:
+      read_aspif_external(&s);
+      break;
+    case 6:
+      read_aspif_assumptions(&s);
+      break;
+    case 10:            /* Comment */
+      skip_line(&s);
+      break;
+    default:
+      if(!s.error[0])
+	snprintf(s.error, ASPIF_ERROR_SIZE, "unsupported statement %i", type);
+    }
+  }
+
+  if(s.error[0]) {
+    if(error)
+      strcpy(error, s.error);
+    if(s.first)
+      free_program(s.first);
+    free_aspif_input(&s);
+    *table = NULL;
+
+    return NULL;
+  }
+
+  /* Skip trailing white space so that the end of file is noticed */
+
+  while((i = getc(in)) == ' ' || i == '\n' || i == '\r' || i == '\t')
+    ;
+  if(i != EOF)
+    ungetc(i, in);
+
+  add_minimize_rules(&s);
+  renumber_aux_atoms(s.first, s.max_atom);
+
+  /* Form the symbol table */
+
+  size = s.max_atom+s.aux_cnt;
+  *table = new_table(size, 0);
+
+  for(i=1; i<=s.max_atom; i++)
+    (*table)->statuses[i] =
+      get_status(&s, i) & (MARK_TRUE_OR_FALSE|MARK_INPUT);
+
+  if(s.false_atom)
+    (*table)->statuses[s.max_atom+1+(s.false_atom-AUX_BASE)] |= MARK_FALSE;
+
+  for(i=0; i<s.name_cnt; i++) {
+    int atom = s.named[i];
+
+    if(atom >= AUX_BASE)
+      atom = s.max_atom+1+(atom-AUX_BASE);
+    (*table)->names[atom] = find_symbol(s.names[i]);
+    free(s.names[i]);
+  }
+
+  free(s.names);
+  free(s.named);
+  free(s.hash);
+  free(s.statuses);
+
+  return s.first;
+}
+
+/* ------------------------------- Writing --------------------------------- */
+
+void write_aspif_header(FILE *out)
+{
+  fprintf(out, "asp 1 0 0\n");
+
+  return;
+}
+
+void write_aspif_body(FILE *out, int pos_cnt, int *pos, int neg_cnt, int *neg,
+		      int weighted, int *weight)
+{
+  int i = 0;
+
+  fprintf(out, " %i", pos_cnt+neg_cnt);
+
+  for(i=0; i<neg_cnt; i++) {
+    fprintf(out, " -%i", neg[i]);
+    if(weighted)
+      fprintf(out, " %i", weight ? weight[i] : 1);
+  }
+
+  for(i=0; i<pos_cnt; i++) {
+    fprintf(out, " %i", pos[i]);
+    if(weighted)
+      fprintf(out, " %i", weight ? weight[neg_cnt+i] : 1);
+  }
+
+  fprintf(out, "\n");
+
+  return;
+}
+
+void write_aspif_heads(FILE *out, int choice, int cnt, int *heads)
+{
+  int i = 0;
+
+  fprintf(out, "1 %i %i", choice, cnt);
+  for(i=0; i<cnt; i++)
+    fprintf(out, " %i", heads[i]);
+
+  return;
+}
+
+/* Returns -1 for rule types not expressible in aspif (0 otherwise) */
+
+int write_aspif_rule(FILE *out, RULE *rule, int priority)
+{
+  int pos_cnt = get_pos_cnt(rule);
+  int *pos = get_pos(rule);
+  int neg_cnt = get_neg_cnt(rule);
+  int *neg = get_neg(rule);
+
+  switch(rule->type) {
+  case TYPE_BASIC:
+    write_aspif_heads(out, 0, 1, &rule->data.basic->head);
+    fprintf(out, " 0");
+    write_aspif_body(out, pos_cnt, pos, neg_cnt, neg, 0, NULL);
+    break;
+
+  case TYPE_CONSTRAINT:
+    write_aspif_heads(out, 0, 1, &rule->data.constraint->head);
+    fprintf(out, " 1 %i", rule->data.constraint->bound);
+    write_aspif_body(out, pos_cnt, pos, neg_cnt, neg, -1, NULL);
+    break;
+
+  case TYPE_CHOICE:
+    write_aspif_heads(out, 1, rule->data.choice->head_cnt,
+		      rule->data.choice->head);
+    fprintf(out, " 0");
+    write_aspif_body(out, pos_cnt, pos, neg_cnt, neg, 0, NULL);
+    break;
+
+  case TYPE_INTEGRITY:
+    write_aspif_heads(out, 0, 0, NULL);
+    fprintf(out, " 0");
+    write_aspif_body(out, pos_cnt, pos, neg_cnt, neg, 0, NULL);
+    break;
+
+  case TYPE_WEIGHT:
+    write_aspif_heads(out, 0, 1, &rule->data.weight->head);
+    fprintf(out, " 1 %i", rule->data.weight->bound);
+    write_aspif_body(out, pos_cnt, pos, neg_cnt, neg,
+		     -1, rule->data.weight->weight);
+    break;
+
+  case TYPE_OPTIMIZE:
+    fprintf(out, "2 %i", priority);
+    write_aspif_body(out, pos_cnt, pos, neg_cnt, neg,
+		     -1, rule->data.optimize->weight);
+    break;
+
+  case TYPE_DISJUNCTIVE:
+    write_aspif_heads(out, 0, rule->data.disjunctive->head_cnt,
+		      rule->data.disjunctive->head);
+    fprintf(out, " 0");
+    write_aspif_body(out, pos_cnt, pos, neg_cnt, neg, 0, NULL);
+    break;
+
+  default:
+    return -1;
+  }
+
+  return 0;
+}
+
+/*
+ * write_aspif_minimize -- Write the minimize statements of a program with
+ * increasing priorities (the last statement is the most important one);
+ * the next free priority is returned
+ */
+
+int write_aspif_minimize(FILE *out, RULE *program, int priority)
+{
+  RULE *rule = NULL;
+
+  for(rule = program; rule; rule = rule->next)
+    if(rule->type == TYPE_OPTIMIZE)
+      write_aspif_rule(out, rule, priority++);
+
+  return priority;
+}
+
+/* Returns -1 if some rule is not expressible in aspif */
+
+int write_aspif_program(FILE *out, RULE *program, int priority)
+{
+  RULE *rule = NULL;
+
+  for(rule = program; rule; rule = rule->next)
+    if(rule->type != TYPE_OPTIMIZE && write_aspif_rule(out, rule, 0))
+      return -1;
+
+  return write_aspif_minimize(out, program, priority);
+}
+
+/* Output directives for named atoms */
+
+void write_aspif_symbols(FILE *out, ATAB *table)
+{
+  char *text = NULL;
+  size_t len = 0;
+  FILE *name = open_memstream(&text, &len);
+  int i = 0;
+
+  for(; table; table = table->next)
+    for(i=1; i<=table->count; i++) {
+      SYMBOL *sym = table->names[i];
+
+      if(sym) {
+	rewind(name);
+	write_name(name, sym, table->prefix, table->postfix);
+	fflush(name);
+	fprintf(out, "4 %i ", (int)len);
+	fwrite(text, 1, len, out);
+	fprintf(out, " 1 %i\n", i+table->offset);
+      }
+    }
+
+  fclose(name);
+  free(text);
+
+  return;
+}
+
+/*
+ * write_aspif_tables -- Write the sections following rules: output
+ * directives, the compute statement as integrity constraints, input
+ * atoms as free externals, and the end of the program
+ */
+
+void write_aspif_tables(FILE *out, ATAB *table)
+{
+  ATAB *scan = NULL;
+  int i = 0;
+
+  write_aspif_symbols(out, table);
+
+  for(scan = table; scan; scan = scan->next)
+    for(i=1; i<=scan->count; i++) {
+      int atom = i+scan->offset;
+      int status = scan->statuses[i];
+
+      if(status & MARK_TRUE)
+	fprintf(out, "1 0 0 0 1 -%i\n", atom);
+      if(status & MARK_FALSE)
+	fprintf(out, "1 0 0 0 1 %i\n", atom);
+      if(status & MARK_INPUT)
+	fprintf(out, "5 %i 0\n", atom);
+    }
+
+  fprintf(out, "0\n");
+
+  return;
+}
+
+/*
+ * write_rule_as -- Write a rule in any style; in the aspif style,
+ * minimize statements are left for write_aspif_minimize
+ */
+
+int write_rule_as(int style, FILE *out, RULE *rule, ATAB *table)
+{
+  if(style != STYLE_ASPIF)
+    write_rule(style, out, rule, table);
+  else if(rule->type != TYPE_OPTIMIZE)
+    return write_aspif_rule(out, rule, 0);
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+/*
+ * Reading and writing programs in the aspif format (clingo/clasp)
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+/* Version information */
+
+#define _ASPIF_H_RCSFILE  "$RCSfile: aspif.h,v $"
+#define _ASPIF_H_DATE     "$Date: 2026/10/18 20:00:00 $"
+#define _ASPIF_H_REVISION "$Revision: 1.1 $"
+
+extern void _version_aspif_c();
+
+/* An output style not known to liblp (see write_rule_as) */
+
+#define STYLE_ASPIF 100
+
+#define ASPIF_ERROR_SIZE 64   /* Room for error messages of read_aspif */
+
+/* Minimize statements and names collected while reading */
+
+typedef struct aspifmin {
+  int number;           /* Order of appearance */
+  int priority;
+  int cnt;              /* Number of weighted literals */
+  int *lits;            /* Literals (negative for default negation) */
+  int *weights;
+} ASPIFMIN;
+
+typedef struct aspifin {
+  FILE *in;
+  int max_atom;         /* Largest atom number seen */
+  int aux_cnt;          /* Number of new atoms */
+  int false_atom;       /* Head for integrity constraints (0 if none) */
+  RULE *first;          /* Rules read so far */
+  RULE *last;
+  int min_cnt;          /* Minimize statements */
+  int min_size;
+  ASPIFMIN *mins;
+  int name_cnt;         /* Output statements */
+  int name_size;
+  char **names;
+  int *named;           /* Atoms standing for names */
+  int hash_size;        /* Open addressing for names (a power of two) */
+  int *hash;            /* Index+1 of the name (0 if free) */
+  int status_size;
+  int *statuses;        /* Compute statement, input atoms, and names */
+  char error[ASPIF_ERROR_SIZE];  /* The first error (empty if none) */
+} ASPIFIN;
+
+extern int is_aspif(FILE *in);
+extern RULE *read_aspif(FILE *in, ATAB **table, char *error);
+
+extern void write_aspif_header(FILE *out);
+extern int write_aspif_rule(FILE *out, RULE *rule, int priority);
+extern int write_aspif_minimize(FILE *out, RULE *program, int priority);
+extern int write_aspif_program(FILE *out, RULE *program, int priority);
+extern void write_aspif_symbols(FILE *out, ATAB *table);
+extern void write_aspif_tables(FILE *out, ATAB *table);
+extern int write_rule_as(int style, FILE *out, RULE *rule, ATAB *table);
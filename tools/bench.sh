@@ -0,0 +1,218 @@
+#!/bin/sh
+# asptools -- Tool collection for answer set programming
+#
+# Copyright (C) 2022 Tomi Janhunen
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or
+# (at your option) any later version.
+#
+# End-to-end benchmark of lpcat and lpshift (see "make bench")
+#
+# Usage: bench.sh [ -s | -n | -r ]
+#
+# A fixed corpus is generated by lpgen into $BENCHDIR unless it exists
+# there already: many small modules, a few huge modules, wide disjunctive
+# rules, and deep recursion through big SCCs. The wall time, peak RSS,
+# and input/output rates of each command are written into a JSON report
+# and compared with a baseline report; the script fails if some time or
+# memory usage exceeds the baseline by more than $THRESHOLD percent.
+# With -s, the report is stored as the new baseline instead, and with -n
+# it is not compared at all. With -r, differences are only reported.
+#
+# (c) 2026 Tomi Janhunen
+
+LPCAT=${LPCAT:-./lpcat}
+LPSHIFT=${LPSHIFT:-./lpshift}
+LPGEN=${LPGEN:-./lpgen}
+MEASURE=${MEASURE:-./measure}
+
+BENCHDIR=${BENCHDIR:-bench-corpus}
+REPORT=${REPORT:-bench-report.json}
+BASELINE=${BASELINE:-bench-baseline.json}
+THRESHOLD=${THRESHOLD:-10}   # Percent
+MINWALL=${MINWALL:-0.05}     # Seconds; smaller differences are noise
+ROUNDS=${ROUNDS:-3}
+
+CORPORA="small huge wide deep"
+
+mode=compare
+case "$#:$1" in
+0:)   ;;
+1:-s) mode=store ;;
+1:-n) mode=none ;;
+1:-r) mode=report ;;
+*)    echo "usage: $0 [ -s | -n | -r ]" >&2
+      exit 1 ;;
+esac
+
+out=${TMPDIR:-/tmp}/bench.$$.out
+results=${TMPDIR:-/tmp}/bench.$$.results
+trap 'rm -f $out $results' 0 1 2 15
+
+# ------------------------- Corpus -------------------------------------------
+
+generate() {
+  case $1 in
+  small) $LPGEN -n=200 -r=400 -m=500 -s=10 -M -x=1 -o=$BENCHDIR/small ;;
+  huge)  $LPGEN -n=500000 -r=1000000 -m=3 -s=5 -M -x=2 -o=$BENCHDIR/huge ;;
+  wide)  $LPGEN -n=20000 -r=40000 -t=20,0,0,80,0 -w=10-40 -x=3 \
+		-o=$BENCHDIR/wide ;;
+  deep)  $LPGEN -n=100000 -r=150000 -c=2000-10000 -x=4 -o=$BENCHDIR/deep ;;
+  esac
+}
+
+# The modules of a corpus in the order of their numbers
+
+modules() {
+  i=1
+  while [ -f $BENCHDIR/$1-$i.sm ]
+  do
+    echo $BENCHDIR/$1-$i.sm
+    i=`expr $i + 1`
+  done
+}
+
+mkdir -p $BENCHDIR || exit 1
+
+for c in $CORPORA
+do
+  if [ ! -f $BENCHDIR/$c.lp ]
+  then
+    echo "bench: generating corpus $c" >&2
+    rm -f $BENCHDIR/$c-*.sm
+    generate $c || exit 1
+    $LPCAT `modules $c` > $BENCHDIR/$c.tmp &&
+    mv $BENCHDIR/$c.tmp $BENCHDIR/$c.lp || exit 1
+  fi
+done
+
+# ------------------------- Measurements -------------------------------------
+
+size() {
+  cat "$@" | wc -c | tr -d ' '
+}
+
+# measure <corpus> <name> <input files> -- <command> <arguments> ...
+
+measure() {
+  corpus=$1; name=$2; shift 2
+  inputs=
+  while [ "$1" != "--" ]
+  do
+    inputs="$inputs $1"; shift
+  done
+  shift
+
+  echo "bench: $name on corpus $corpus" >&2
+
+  best=
+  rss=0
+  i=0
+  while [ $i -lt $ROUNDS ]
+  do
+    result=`$MEASURE $out "$@" $inputs` || {
+      echo "bench: $name failed on corpus $corpus" >&2
+      return 1
+    }
+    wall=${result% *}
+    kb=${result#* }
+    best=`echo "$wall $best" | awk '{ print ($2 == "" || $1 < $2) ? $1 : $2 }'`
+    [ $kb -gt $rss ] && rss=$kb
+    i=`expr $i + 1`
+  done
+
+  echo "$corpus $name $best $rss `size $inputs` `size $out`" |
+  awk '{ printf("    { \"corpus\": \"%s\", \"command\": \"%s\", ", $1, $2);
+         printf("\"wall\": %.6f, \"rss_kb\": %d, ", $3, $4);
+         printf("\"in_bytes\": %d, \"out_bytes\": %d, ", $5, $6);
+         printf("\"in_bps\": %.0f, \"out_bps\": %.0f }\n",
+                $3 > 0 ? $5/$3 : 0, $3 > 0 ? $6/$3 : 0) }'
+}
+
+for c in $CORPORA
+do
+  files=`modules $c`
+  linked=$BENCHDIR/$c.lp
+  measure $c lpcat $files -- $LPCAT &&
+  measure $c lpcat-c-m $files -- $LPCAT -c -m &&
+  measure $c lpshift $linked -- $LPSHIFT &&
+  measure $c lpshift-bc $linked -- $LPSHIFT --bc &&
+  measure $c lpshift-f $linked -- $LPSHIFT -f || exit 1
+done > $results
+
+{
+  echo "{"
+  echo "  \"date\": \"`date -u +%Y-%m-%dT%H:%M:%SZ`\","
+  echo "  \"host\": \"`uname -n`\","
+  echo "  \"rounds\": $ROUNDS,"
+  echo "  \"results\": ["
+  sed '$!s/}$/},/' $results
+  echo "  ]"
+  echo "}"
+} > $REPORT.tmp || exit 1
+
+mv $REPORT.tmp $REPORT
+echo "bench: report written to $REPORT" >&2
+
+# ------------------------- Comparison with the baseline ---------------------
+
+if [ $mode = store ]
+then
+  cp $REPORT $BASELINE
+  echo "bench: baseline stored in $BASELINE" >&2
+  exit 0
+elif [ $mode = none ]
+then
+  exit 0
+fi
+
+if [ ! -f $BASELINE ]
+then
+  echo "bench: no baseline $BASELINE (store one with make bench-baseline)" >&2
+  exit 0
+fi
+
+awk -v threshold=$THRESHOLD -v minwall=$MINWALL -v mode=$mode '
+function field(name,   s) {
+  if(!match($0, "\"" name "\": [^,}]*"))
+    return ""
+  s = substr($0, RSTART, RLENGTH)
+  sub(/^[^:]*: /, "", s)
+  gsub(/"/, "", s)
+  return s
+}
+/"corpus"/ {
+  key = field("corpus") " " field("command")
+  if(FILENAME == ARGV[1]) {
+    wall[key] = field("wall")+0; rss[key] = field("rss_kb")+0
+    next
+  }
+  if(!(key in wall)) {
+    printf("%-24s %10s (not in baseline)\n", key, field("wall"))
+    next
+  }
+  w = field("wall")+0; r = field("rss_kb")+0
+  slow = (w > wall[key]*(1+threshold/100) && w - wall[key] > minwall)
+  big = (r > rss[key]*(1+threshold/100))
+  status = slow ? (big ? "REGRESSION (time, memory)" : "REGRESSION (time)") \
+                : (big ? "REGRESSION (memory)" : "ok")
+  if(slow || big)
+    failed++
+  if(w > 0 && wall[key] > 0) {
+    logratio += log(w/wall[key]); ratios++
+  }
+  printf("%-24s %10.3f s %+7.1f%% %10d kB %+7.1f%%  %s\n", key,
+         w, wall[key] > 0 ? 100*(w-wall[key])/wall[key] : 0,
+         r, rss[key] > 0 ? 100*(r-rss[key])/rss[key] : 0, status)
+}
+END {
+  if(ratios)
+    printf("bench: %.2fx speedup over the baseline (geometric mean)\n",
+           exp(-logratio/ratios))
+  if(failed && mode == "compare") {
+    printf("bench: %d regressions beyond %s%%\n", failed, threshold)
+    exit 1
+  }
+}' $BASELINE $REPORT
@@ -0,0 +1,311 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+/*
+ * Caching of dependency analysis: the head-occurrence index and the SCCs
+ * based on positive dependencies are saved in a sidecar file and loaded
+ * back by later runs on a program with the same content hash
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "version.h"
+#include "symbol.h"
+#include "atom.h"
+#include "rule.h"
+#include "scc.h"
+#include "cache.h"
+
+void _version_cache_h()
+{
+  _version(_CACHE_H_RCSFILE, _CACHE_H_DATE, _CACHE_H_REVISION);
+}
+
+void _version_cache_c()
+{
+  _version_cache_h();
+  _version("$RCSfile: cache.c,v $",
+	   "$Date: 2026/10/18 19:00:00 $",
+	   "$Revision: 1.1 $");
+}
+
+/* ------------------------- Content hash (FNV-1a) ------------------------- */
+
+unsigned long long hash_int(unsigned long long hash, int value)
+{
+  unsigned int v = (unsigned int)value;
+  int i = 0;
+
+  for(i=0; i<4; i++) {
+    hash = (hash ^ (v & 0xff)) * 1099511628211ULL;
+    v >>= 8;
+  }
+
+  return hash;
+}
+
+unsigned long long hash_list(unsigned long long hash, int cnt, int *atoms)
+{
+  int i = 0;
+
+  hash = hash_int(hash, cnt);
+  for(i=0; i<cnt; i++)
+    hash = hash_int(hash, atoms[i]);
+
+  return hash;
+}
+
+/*
+ * hash_program -- Hash everything the analysis depends on: the rules
+ * (bounds and weights excluded), the pieces of the symbol table, and
+ * the modules of atoms (for module conditions)
+ */
+
+unsigned long long hash_program(RULE *program, ATAB *table)
+{
+  unsigned long long hash = 14695981039346656037ULL;
+  RULE *rule = NULL;
+  int i = 0;
+
+  for(rule = program; rule; rule = rule->next) {
+    hash = hash_int(hash, rule->type);
+    hash = hash_list(hash, get_head_cnt(rule), get_heads(rule));
+    hash = hash_list(hash, get_pos_cnt(rule), get_pos(rule));
+    hash = hash_list(hash, get_neg_cnt(rule), get_neg(rule));
+  }
+
+  for(; table; table = table->next) {
+    hash = hash_int(hash, table->offset);
+    hash = hash_int(hash, table->count);
+
+    for(i=1; i<=table->count; i++) {
+      SYMBOL *sym = table->names[i];
+
+      hash = hash_int(hash, sym ? sym->info.module : 0);
+    }
+  }
+
+  return hash;
+}
+
+/* ------------------------ Loading a sidecar file ------------------------- */
+
+int count_rules(RULE *program)
+{
+  int cnt = 0;
+
+  for(; program; program = program->next)
+    cnt++;
+
+  return cnt;
+}
+
+/*
+ * load_analysis -- Fill in the head-occurrence index and SCCs of atoms
+ * from the file (mapped to memory) if it matches the hash; return the
+ * flags of the file or 0 if the analysis has to be computed
+ */
+
+int load_analysis(char *file, unsigned long long hash,
+		  RULE *program, OCCTAB *occtab, int max_atom)
+{
+  CACHEHEADER *header = NULL;
+  struct stat st;
+  void *base = NULL;
+  int *scc = NULL, *scc_size = NULL, *first = NULL, *index = NULL;
+  RULE **rules = NULL;
+  RULE *rule = NULL;
+  int rule_cnt = count_rules(program);
+  int valid = 0;
+  int rvalue = 0;
+  int fd = 0;
+  int i = 0, j = 0;
+
+  if((fd = open(file, O_RDONLY)) < 0)
+    return 0;
+
+  if(fstat(fd, &st) < 0 || st.st_size < sizeof(CACHEHEADER)) {
+    close(fd);
+    return 0;
+  }
+
+  base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if(base == MAP_FAILED)
+    return 0;
+
+  header = (CACHEHEADER *)base;
+  scc = (int *)&header[1];
+  scc_size = &scc[max_atom+1];
+  first = &scc_size[max_atom+1];
+  index = &first[max_atom+2];
+
+  /* Check that the file belongs to this program and is intact */
+
+  valid = (header->magic == CACHE_MAGIC && header->hash == hash
+	   && header->max_atom == max_atom && header->rule_cnt == rule_cnt
+	   && header->head_cnt >= 0
+	   && st.st_size == sizeof(CACHEHEADER)
+	   + sizeof(int)*(3*(off_t)max_atom+4+header->head_cnt));
+
+  for(i=1; valid && i<=max_atom; i++)
+    if(first[i] > first[i+1] || !find_occurrences(occtab, i))
+      valid = 0;
+
+  if(valid)
+    valid = (first[1] == 0 && first[max_atom+1] == header->head_cnt);
+
+  for(i=0; valid && i<header->head_cnt; i++)
+    if(index[i] < 0 || index[i] >= rule_cnt)
+      valid = 0;
+
+  if(valid) {
+    rules = (RULE **)malloc((rule_cnt+1)*sizeof(RULE *));
+    for(rule = program, i = 0; rule; rule = rule->next)
+      rules[i++] = rule;
+
+    for(i=1; i<=max_atom; i++) {
+      OCCURRENCES *h = find_occurrences(occtab, i);
+      int cnt = first[i+1]-first[i];
+
+      h->scc = scc[i];
+      h->scc_size = scc_size[i];
+      h->visited = max_atom+1;
+      h->rule_cnt = cnt;
+
+      if(cnt) {
+	h->rules = (RULE **)malloc(cnt*sizeof(RULE *));
+	for(j=0; j<cnt; j++)
+	  h->rules[j] = rules[index[first[i]+j]];
+      }
+    }
+
+    free(rules);
+    rvalue = header->flags | CACHE_VALID;
+  }
+
+  munmap(base, st.st_size);
+
+  return rvalue;
+}
+
+/* ------------------------- Saving a sidecar file ------------------------- */
+
+/*
+ * save_analysis -- Write the SCCs found in occtab and the head-occurrence
+ * index of the program; the file is replaced atomically so that parallel
+ * runs never see it half-written
+ */
+
+void save_analysis(char *file, unsigned long long hash,
+		   RULE *program, OCCTAB *occtab, int max_atom, int flags)
+{
+  CACHEHEADER header;
+  int *scc = (int *)calloc(2*(max_atom+1), sizeof(int));
+  int *scc_size = &scc[max_atom+1];
+  int *first = (int *)calloc(max_atom+2, sizeof(int));
+  int *index = NULL;
+  char *tmp = (char *)malloc(strlen(file)+32);
+  RULE *rule = NULL;
+  FILE *out = NULL;
+  int head_cnt = 0;
+  int rule_cnt = 0;
+  int ok = 0;
+  int i = 0, j = 0;
+
+  for(i=1; i<=max_atom; i++) {
+    OCCURRENCES *h = find_occurrences(occtab, i);
+
+    if(h) {
+      scc[i] = h->scc;
+      scc_size[i] = h->scc_size;
+    }
+  }
+
+  /* Counting sort of head occurrences by atoms */
+
+  for(rule = program; rule; rule = rule->next) {
+    int *heads = get_heads(rule);
+    int cnt = get_head_cnt(rule);
+
+    for(j=0; j<cnt; j++)
+      first[heads[j]+1]++;
+    head_cnt += cnt;
+    rule_cnt++;
+  }
+
+  for(i=1; i<=max_atom; i++)
+    first[i+1] += first[i];
+
+  index = (int *)malloc((head_cnt+1)*sizeof(int));
+
+  for(rule = program, i = 0; rule; rule = rule->next, i++) {
+    int *heads = get_heads(rule);
+    int cnt = get_head_cnt(rule);
+
+    for(j=0; j<cnt; j++)
+      index[first[heads[j]]++] = i;
+  }
+
+  for(i=max_atom+1; i>0; i--)
+    first[i] = first[i-1];
+  first[0] = 0;
+
+  memset(&header, 0, sizeof(CACHEHEADER));
+  header.magic = CACHE_MAGIC;
+  header.flags = flags & ~CACHE_VALID;
+  header.hash = hash;
+  header.max_atom = max_atom;
+  header.rule_cnt = rule_cnt;
+  header.head_cnt = head_cnt;
+
+  sprintf(tmp, "%s.%i", file, (int)getpid());
+
+  if(out = fopen(tmp, "wb")) {
+    ok = (fwrite(&header, sizeof(CACHEHEADER), 1, out) == 1
+	  && fwrite(scc, sizeof(int), 2*(max_atom+1), out) == 2*(max_atom+1)
+	  && fwrite(first, sizeof(int), max_atom+2, out) == max_atom+2
+	  && fwrite(index, sizeof(int), head_cnt, out) == head_cnt);
+    if(fclose(out) != 0)
+      ok = 0;
+  }
+
+  if(!ok || rename(tmp, file) != 0) {
+    fprintf(stderr, "%s: cannot write cache file %s\n", program_name, file);
+    unlink(tmp);
+  }
+
+  free(scc);
+  free(first);
+  free(index);
+  free(tmp);
+
+  return;
+}
@@ -0,0 +1,60 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+/*
+ * Sidecar files for caching the analysis of positive dependencies
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+/* Version information */
+
+#define _CACHE_H_RCSFILE  "$RCSfile: cache.h,v $"
+#define _CACHE_H_DATE     "$Date: 2026/10/18 19:00:00 $"
+#define _CACHE_H_REVISION "$Revision: 1.1 $"
+
+extern void _version_cache_c();
+
+/* Layout of a sidecar file: the header is followed by int arrays
+   scc[max_atom+1], scc_size[max_atom+1], first[max_atom+2], and
+   index[head_cnt] so that the rules having atom a as head are
+   index[first[a]], ..., index[first[a+1]-1] (numbered in program order) */
+
+#define CACHE_MAGIC   0x4c504361  /* "LPCa" */
+
+#define CACHE_VALID   0x1         /* Returned for any successful load */
+#define CACHE_MODULAR 0x2         /* Module conditions have been checked */
+
+typedef struct cacheheader {
+  int magic;
+  int flags;
+  unsigned long long hash;  /* Content hash of the program */
+  int max_atom;             /* Number of atoms */
+  int rule_cnt;             /* Number of rules */
+  int head_cnt;             /* Number of head occurrences */
+  int reserved;
+} CACHEHEADER;
+
+extern unsigned long long hash_program(RULE *program, ATAB *table);
+extern int load_analysis(char *file, unsigned long long hash,
+			 RULE *program, OCCTAB *occtab, int max_atom);
+extern void save_analysis(char *file, unsigned long long hash,
+			  RULE *program, OCCTAB *occtab, int max_atom,
+			  int flags);
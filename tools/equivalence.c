@@ -0,0 +1,206 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Collapsing of equivalent atoms: rules of the form a :- b. make the
+ * atoms of each SCC over such rules equivalent in every answer set, as
+ * does a :- b. alone when it is the only rule defining a
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "version.h"
+#include "symbol.h"
+#include "atom.h"
+#include "rule.h"
+#include "io.h"
+#include "scc.h"
+#include "relocate.h"
+#include "normalize.h"
+#include "equivalence.h"
+
+void _version_equivalence_h()
+{
+  _version(_EQUIVALENCE_H_RCSFILE, _EQUIVALENCE_H_DATE,
+	   _EQUIVALENCE_H_REVISION);
+}
+
+void _version_equivalence_c()
+{
+  _version_equivalence_h();
+  _version("$RCSfile: equivalence.c,v $",
+	   "$Date: 2026/10/18 14:00:00 $",
+	   "$Revision: 1.1 $");
+}
+
+RULE *new_copy_rule(int head, int body)
+{
+  RULE *rule = (RULE *)malloc(sizeof(RULE));
+  BASIC_RULE *basic = (BASIC_RULE *)malloc(sizeof(BASIC_RULE));
+
+  basic->head = head;
+  basic->pos_cnt = 1;
+  basic->pos = (int *)malloc(sizeof(int));
+  basic->pos[0] = body;
+  basic->neg_cnt = 0;
+  basic->neg = NULL;
+
+  rule->type = TYPE_BASIC;
+  rule->data.basic = basic;
+  rule->next = NULL;
+
+  return rule;
+}
+
+/* Does the rule refer to atoms replaced by their representatives */
+
+int has_substitutes(int cnt, int *atoms, ATAB *table)
+{
+  int i = 0;
+
+  for(i=0; i<cnt; i++)
+    if(table->others[atoms[i]-table->offset] != atoms[i])
+      return -1;
+
+  return 0;
+}
+
+int is_substituted(RULE *rule, ATAB *table)
+{
+  return has_substitutes(get_head_cnt(rule), get_heads(rule), table)
+    || has_substitutes(get_pos_cnt(rule), get_pos(rule), table)
+    || has_substitutes(get_neg_cnt(rule), get_neg(rule), table);
+}
+
+RULE *collapse_equivalences(RULE *program, ATAB *table, EQSTATS *stats)
+{
+  OCCTAB *occtab = NULL;
+  OCCURRENCES *ashead = NULL;
+  int max_atom = table_size(table);
+  int count = 0;
+  int offset = 0;
+  int *rep = NULL;       /* Representatives indexed by SCCs */
+  int *others = NULL;
+  RULE *copies = NULL;   /* Rules for visible atoms other than reps */
+  RULE **scan = NULL;
+  NORMSTATS normstats = { 0, 0, 0, 0, 0 };
+  int i = 0;
+
+  if(!table || table->next) {
+    fprintf(stderr, "%s: contiguous symbol table expected!\n",
+	    program_name);
+    exit(-1);
+  }
+
+  count = table->count;
+  offset = table->offset;
+
+  occtab = initialize_occurrences(table);
+  compute_occurrences(program, occtab, 0);
+  compute_equivalences(occtab, max_atom);
+  ashead = occtab->ashead;
+
+  /* Prefer visible atoms as representatives of classes */
+
+  rep = (int *)calloc(max_atom+2, sizeof(int));
+
+  for(i=1; i<=count; i++) {
+    OCCURRENCES *h = &ashead[i];
+    int r = rep[h->scc];
+
+    if(h->scc_size < 2)
+      continue;
+
+    if(!r || (!(ashead[r-offset].status & MARK_VISIBLE)
+	      && (h->status & MARK_VISIBLE)))
+      rep[h->scc] = i+offset;
+  }
+
+  /* Substitute representatives for atoms using relocation */
+
+  if(table->others)
+    free(table->others);
+  others = table->others = (int *)malloc((count+1)*sizeof(int));
+
+  for(i=1; i<=count; i++) {
+    OCCURRENCES *h = &ashead[i];
+    int atom = i+offset;
+    int r = atom;
+
+    if(h->scc_size > 1)
+      r = rep[h->scc];
+
+    others[i] = r;
+
+    if(r == atom) {
+      if(h->scc_size > 1)
+	stats->classes++;
+      continue;
+    }
+
+    stats->atoms++;
+
+    if(h->status & MARK_VISIBLE) {
+      RULE *copy = new_copy_rule(atom, r);
+
+      copy->next = copies;
+      copies = copy;
+    } else
+      table->statuses[r-offset] |= (table->statuses[i] & MARK_TRUE_OR_FALSE);
+  }
+
+  /* Relocate the rules affected and remove tautologies like a :- a. and
+     duplicate literals created thereby; other rules are left intact */
+
+  for(scan = &program; *scan; ) {
+    RULE *rule = *scan;
+
+    if(is_substituted(rule, table)) {
+      reloc_rule(rule, table);
+
+      if(normalize_rule(rule, &normstats) != KEEP_RULE) {
+	*scan = rule->next;
+	rule->next = NULL;
+	free_program(rule);
+	stats->rules++;
+	continue;
+      }
+    }
+    scan = &rule->next;
+  }
+
+  free(table->others);
+  table->others = NULL;
+  free(rep);
+  free_occurrences(occtab);
+
+  return append_rules(program, copies);
+}
+
+void write_equivalence_stats(FILE *out, EQSTATS *stats)
+{
+  fprintf(out, "%s: collapsed %i atoms into %i classes ", program_name,
+	  stats->atoms, stats->classes);
+  fprintf(out, "(%i rules removed)\n", stats->rules);
+
+  return;
+}
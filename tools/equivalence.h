@@ -0,0 +1,46 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Collapsing of equivalent atoms
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+/* Version information */
+
+#define _EQUIVALENCE_H_RCSFILE  "$RCSfile: equivalence.h,v $"
+#define _EQUIVALENCE_H_DATE     "$Date: 2026/10/18 14:00:00 $"
+#define _EQUIVALENCE_H_REVISION "$Revision: 1.1 $"
+
+extern void _version_equivalence_c();
+
+/* Statistics on equivalences */
+
+typedef struct eqstats {
+  int classes;          /* Number of non-trivial classes */
+  int atoms;            /* Number of atoms substituted */
+  int rules;            /* Number of rules removed */
+} EQSTATS;
+
+/* Utilities */
+
+extern RULE *collapse_equivalences(RULE *program, ATAB *table,
+				   EQSTATS *stats);
+extern void write_equivalence_stats(FILE *out, EQSTATS *stats);
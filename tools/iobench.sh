@@ -0,0 +1,63 @@
+#!/bin/sh
+# asptools -- Tool collection for answer set programming
+#
+# Copyright (C) 2022 Tomi Janhunen
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or
+# (at your option) any later version.
+#
+# Throughput of lpcat and lpshift on SMODELS versus aspif input
+#
+# Usage: iobench.sh <program in SMODELS format> [ <rounds> ]
+#
+# (c) 2026 Tomi Janhunen
+
+LPCAT=${LPCAT:-./lpcat}
+LPSHIFT=${LPSHIFT:-./lpshift}
+
+if [ $# -lt 1 ] || [ ! -r "$1" ]
+then
+  echo "usage: $0 <program in SMODELS format> [ <rounds> ]" >&2
+  exit 1
+fi
+
+sm=$1
+rounds=${2:-3}
+tmp=${TMPDIR:-/tmp}/iobench.$$
+aspif=$tmp.aspif
+
+trap 'rm -f $tmp.*' 0 1 2 15
+
+$LPCAT -c --aspif "$sm" > $aspif || exit 1
+
+now() {
+  date +%s.%N
+}
+
+# Run "$@" on input file $1 for $rounds rounds and print MB/s
+
+bench() {
+  label=$1; file=$2; shift 2
+  bytes=`wc -c < $file`
+  start=`now`
+  i=0
+  while [ $i -lt $rounds ]
+  do
+    "$@" $file > /dev/null || exit 1
+    i=`expr $i + 1`
+  done
+  end=`now`
+  echo "$label $bytes $start $end $rounds" |
+  awk '{ t = ($4-$3)/$5;
+         printf("%-24s %12d bytes %9.3f s %9.2f MB/s\n",
+                $1, $2, t, t > 0 ? $2/t/1048576 : 0) }'
+}
+
+bench lpcat-smodels     "$sm"    $LPCAT
+bench lpcat-aspif       $aspif   $LPCAT
+bench lpcat-c-smodels   "$sm"    $LPCAT -c
+bench lpcat-c-aspif     $aspif   $LPCAT -c
+bench lpshift-smodels   "$sm"    $LPSHIFT
+bench lpshift-aspif     $aspif   $LPSHIFT
@@ -0,0 +1,1593 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Linking of program modules (the link loop of LPCAT as a library)
+ *
+ * (c) 2002-2010 Tomi Janhunen (the link loop and output routines of LPCAT)
+ * (c) 2026 Tomi Janhunen
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <unistd.h>
+
+#include "version.h"
+#include "symbol.h"
+#include "atom.h"
+#include "rule.h"
+#include "io.h"
+#include "scc.h"
+#include "relocate.h"
+#include "normalize.h"
+#include "cache.h"
+#include "aspif.h"
+#include "linker.h"
+
+void _version_linker_h()
+{
+  _version(_LINKER_H_RCSFILE, _LINKER_H_DATE, _LINKER_H_REVISION);
+}
+
+void _version_linker_c()
+{
+  _version_linker_h();
+  _version("$RCSfile: linker.c,v $",
+	   "$Date: 2026/10/18 18:00:00 $",
+	   "$Revision: 1.1 $");
+}
+
+#define LINK_ERROR_SIZE 1024
+
+typedef struct linkname {
+  SYMBOL *sym;          /* NULL if the slot is free */
+  ATAB *table;          /* Piece containing the atom */
+  int atom;
+  int module;
+} LINKNAME;
+
+struct linker {
+  int flags;
+  int module;           /* Number of modules linked so far */
+  RULE *program;        /* The linked program (if collected) */
+  ATAB *table;          /* The linked symbol table */
+  int size;             /* Number of atoms in the linked program */
+  int number;           /* Number of models to compute */
+  FILE *out;            /* Output for rules (unless collected) */
+  int style;
+  int priority;         /* Next priority of minimize statements in aspif */
+  int status;           /* The first error, if any */
+  int finalized;
+  LINKNAME *names;      /* Map of names while several linkers coexist */
+  int name_cnt;
+  int name_size;        /* A power of two (0 if there is no map) */
+  struct linker *next;  /* The next live linker */
+  NORMSTATS normstats;
+  char error[LINK_ERROR_SIZE];
+};
+
+/* ------------------------- Names of linked atoms ------------------------ */
+
+/* The symbols of liblp are shared by all linkers, and the info of each
+   symbol refers to its atom (and module of -m) in the table of a linker.
+   A single linker keeps the symbols up to date directly. While several
+   linkers coexist, each keeps a map from its symbols to their atoms: the
+   symbols of a module are set from the map of the linker when the module
+   is linked, which costs time in the size of the module rather than the
+   linked program, and all symbols of the linker are set before
+   operations on the whole linked program. */
+
+LINKER *live_linkers = NULL;
+int live_linker_cnt = 0;
+
+unsigned int hash_linked_name(SYMBOL *sym)
+{
+  return (unsigned int)(((unsigned long)sym >> 4) * 2654435761u);
+}
+
+/* The slot of the symbol in the map (or the free slot for it) */
+
+LINKNAME *find_linked_name(LINKER *linker, SYMBOL *sym)
+{
+  unsigned int i = hash_linked_name(sym) & (linker->name_size-1);
+
+  while(linker->names[i].sym && linker->names[i].sym != sym)
+    i = (i+1) & (linker->name_size-1);
+
+  return &linker->names[i];
+}
+
+LINKNAME *lookup_linked_name(LINKER *linker, SYMBOL *sym)
+{
+  LINKNAME *name = NULL;
+
+  if(!linker->name_size)
+    return NULL;
+
+  name = find_linked_name(linker, sym);
+
+  return name->sym ? name : NULL;
+}
+
+/* Record the current info of the symbol in the map */
+
+void record_linked_name(LINKER *linker, SYMBOL *sym)
+{
+  LINKNAME *name = NULL;
+
+  if(2*(linker->name_cnt+1) > linker->name_size) {   /* Rehash */
+    LINKNAME *old = linker->names;
+    int size = linker->name_size;
+    int i = 0;
+
+    linker->name_size = size ? 2*size : 1024;
+    linker->names = (LINKNAME *)calloc(linker->name_size, sizeof(LINKNAME));
+
+    for(i=0; i<size; i++)
+      if(old[i].sym)
+	*find_linked_name(linker, old[i].sym) = old[i];
+    free(old);
+  }
+
+  name = find_linked_name(linker, sym);
+  if(!name->sym)
+    linker->name_cnt++;
+
+  name->sym = sym;
+  name->table = sym->info.table;
+  name->atom = sym->info.atom;
+  name->module = sym->info.module;
+
+  return;
+}
+
+void free_linked_names(LINKER *linker)
+{
+  free(linker->names);
+  linker->names = NULL;
+  linker->name_cnt = 0;
+  linker->name_size = 0;
+
+  return;
+}
+
+/*
+ * map_linked_names -- Form the map of a linker from its table; the atoms
+ * are taken from the table and the modules from the info of symbols, or
+ * from the previous map if there is one
+ */
+
+void map_linked_names(LINKER *linker)
+{
+  LINKNAME *old = linker->names;
+  int size = linker->name_size;
+  ATAB *scan = NULL;
+  int i = 0;
+
+  linker->names = NULL;
+  linker->name_cnt = 0;
+  linker->name_size = 0;
+
+  for(scan = linker->table; scan; scan = scan->next)
+    for(i=1; i<=scan->count; i++) {
+      SYMBOL *sym = scan->names[i];
+
+      if(sym) {
+	if(size) {
+	  unsigned int j = hash_linked_name(sym) & (size-1);
+
+	  while(old[j].sym && old[j].sym != sym)
+	    j = (j+1) & (size-1);
+	  sym->info.module = old[j].sym ? old[j].module : 0;
+	}
+	sym->info.table = scan;
+	sym->info.atom = scan->offset+i;
+	record_linked_name(linker, sym);
+      }
+    }
+
+  free(old);
+
+  return;
+}
+
+/* Set the info of all symbols of the linker (with a map) */
+
+void attach_linked_names(LINKER *linker)
+{
+  int i = 0;
+
+  for(i=0; i<linker->name_size; i++) {
+    LINKNAME *name = &linker->names[i];
+
+    if(name->sym) {
+      name->sym->info.table = name->table;
+      name->sym->info.atom = name->atom;
+      name->sym->info.module = name->module;
+    }
+  }
+
+  return;
+}
+
+void detach_linked_names(LINKER *linker)
+{
+  ATAB *scan = NULL;
+  int i = 0;
+
+  for(scan = linker->table; scan; scan = scan->next)
+    for(i=1; i<=scan->count; i++) {
+      SYMBOL *sym = scan->names[i];
+
+      if(sym) {
+	sym->info.table = NULL;
+	sym->info.atom = 0;
+	sym->info.module = 0;
+      }
+    }
+
+  return;
+}
+
+/* Symbols of a module refer to the atoms of the linker (if any) */
+
+void attach_module_names(LINKER *linker, ATAB *table)
+{
+  int i = 0;
+
+  if(live_linker_cnt == 1)
+    return;
+
+  for(; table; table = table->next)
+    for(i=1; i<=table->count; i++) {
+      SYMBOL *sym = table->names[i];
+
+      if(sym) {
+	LINKNAME *name = lookup_linked_name(linker, sym);
+
+	sym->info.table = name ? name->table : NULL;
+	sym->info.atom = name ? name->atom : 0;
+	sym->info.module = name ? name->module : 0;
+      }
+    }
+
+  return;
+}
+
+/* The symbols of a module to be recorded afterwards (if necessary) */
+
+SYMBOL **module_names(ATAB *table, int *cnt)
+{
+  SYMBOL **syms = NULL;
+  ATAB *scan = NULL;
+  int size = 0;
+  int i = 0;
+
+  *cnt = 0;
+
+  if(live_linker_cnt == 1)
+    return NULL;
+
+  for(scan = table; scan; scan = scan->next)
+    size += scan->count;
+
+  syms = (SYMBOL **)malloc((size+1)*sizeof(SYMBOL *));
+
+  for(scan = table; scan; scan = scan->next)
+    for(i=1; i<=scan->count; i++)
+      if(scan->names[i])
+	syms[(*cnt)++] = scan->names[i];
+
+  return syms;
+}
+
+void record_module_names(LINKER *linker, int cnt, SYMBOL **syms)
+{
+  int i = 0;
+
+  if(live_linker_cnt > 1)
+    for(i=0; i<cnt; i++)
+      record_linked_name(linker, syms[i]);
+
+  return;
+}
+
+/* Before operations on the whole linked program */
+
+void activate_linker(LINKER *linker)
+{
+  if(live_linker_cnt > 1)
+    attach_linked_names(linker);
+
+  return;
+}
+
+void enter_live_linker(LINKER *linker)
+{
+  /* The symbols describe the only other linker exactly until now */
+
+  if(live_linker_cnt == 1)
+    map_linked_names(live_linkers);
+
+  linker->next = live_linkers;
+  live_linkers = linker;
+  live_linker_cnt++;
+
+  return;
+}
+
+void leave_live_linker(LINKER *linker)
+{
+  LINKER **scan = &live_linkers;
+
+  while(*scan != linker)
+    scan = &(*scan)->next;
+  *scan = linker->next;
+  live_linker_cnt--;
+
+  /* Names of other linkers may refer to the freed tables */
+
+  detach_linked_names(linker);
+
+  if(live_linker_cnt == 1) {
+    attach_linked_names(live_linkers);
+    free_linked_names(live_linkers);
+  }
+
+  return;
+}
+
+/* ------------------------- Creating linkers ------------------------------ */
+
+LINKER *new_linker(int flags, int first_atom)
+{
+  LINKER *linker = (LINKER *)calloc(1, sizeof(LINKER));
+
+  if(!linker)
+    return NULL;
+
+  if(!program_name)
+    program_name = "liblplink";
+
+  linker->flags = flags;
+  linker->size = first_atom > 0 ? first_atom-1 : 0;
+  linker->number = 1;
+  linker->style = STYLE_SMODELS;
+
+  enter_live_linker(linker);
+
+  return linker;
+}
+
+void free_linker_tables(ATAB *table)
+{
+  while(table) {
+    ATAB *next = table->next;
+
+    free(table->names);
+    free(table->statuses);
+    free(table->others);
+    free(table);
+
+    table = next;
+  }
+
+  return;
+}
+
+void free_linker(LINKER *linker)
+{
+  if(!linker)
+    return;
+
+  leave_live_linker(linker);
+
+  if(linker->program)
+    free_program(linker->program);
+  free_linker_tables(linker->table);
+  free_linked_names(linker);
+  free(linker);
+
+  return;
+}
+
+/* Rules are written to the output immediately unless collected */
+
+void set_linker_output(LINKER *linker, FILE *out, int style)
+{
+  linker->out = out;
+  linker->style = style;
+
+  return;
+}
+
+int linker_collects(LINKER *linker)
+{
+  return (linker->flags & LINK_COLLECT) || !linker->out;
+}
+
+int linker_fail(LINKER *linker, int status, const char *format, ...)
+{
+  va_list args;
+
+  va_start(args, format);
+  vsnprintf(linker->error, LINK_ERROR_SIZE, format, args);
+  va_end(args);
+
+  if(!linker->status)
+    linker->status = status;
+
+  return status;
+}
+
+/* No more modules after an error or finalization */
+
+int linker_refuses(LINKER *linker)
+{
+  if(linker->status)
+    return LINK_ERROR_STATE;
+
+  if(linker->finalized) {
+    snprintf(linker->error, LINK_ERROR_SIZE, "linker already finalized");
+    return LINK_ERROR_STATE;
+  }
+
+  return LINK_OK;
+}
+
+const char *linker_error(LINKER *linker)
+{
+  return linker->error;
+}
+
+/* ------------------------- Linking modules ------------------------------- */
+
+int link_program(LINKER *linker, RULE *program1, ATAB *table1, int number1)
+{
+  int collect = linker_collects(linker);
+  int size1 = 0;
+  int doubly_defined = 0;
+  int sym_cnt = 0;
+  SYMBOL **syms = NULL;
+
+  if(linker_refuses(linker)) {
+    if(program1)
+      free_program(program1);
+    return LINK_ERROR_STATE;
+  }
+
+  attach_module_names(linker, table1);
+  syms = module_names(table1, &sym_cnt);
+
+  linker->module++;
+
+  if(linker->flags & LINK_MARK_INPUT)
+    /* Atoms having no defining atoms are marked as input atoms */
+    mark_io_atoms(program1, table1, linker->module);
+
+  /* Calculate cross-references from table1 to the linked table */
+
+  initialize_other_tables(table1, linker->table);
+  doubly_defined =
+    combine_atom_tables(table1, linker->table, 0, 0,
+			(linker->flags & LINK_MODULAR) ? -1 : 0);
+
+  if(doubly_defined) {
+    if(linker->flags & LINK_LENIENT) {
+      FILE *out = linker->out ? linker->out : stderr;
+
+      fprintf(out, "%s: warning: ", program_name);
+      write_atom(STYLE_READABLE, out, doubly_defined, table1);
+      fprintf(out, " is defined by several modules!\n");
+    } else {
+      /* The given programs do not form proper modules */
+
+      char *name = NULL;
+      size_t len = 0;
+      FILE *buf = open_memstream(&name, &len);
+
+      if(buf) {
+	write_atom(STYLE_READABLE, buf, doubly_defined, table1);
+	fclose(buf);
+      }
+      linker_fail(linker, LINK_ERROR_MODULE,
+		  "module error: %s is defined by several modules!",
+		  name ? name : "an atom");
+      free(name);
+      free_program(program1);
+      free(syms);
+
+      return LINK_ERROR_MODULE;
+    }
+  }
+
+  /* Relocate/compress the symbol table and relocate rules */
+
+  if(table1 && table1->next)
+    table1 = make_contiguous(table1);  /* Assumed by relocation procedures */
+
+  mark_visible(table1);
+  mark_occurrences(program1, table1);
+
+  size1 = reloc_symbol_table(table1, linker->size) - linker->size;
+
+  if(collect)
+    reloc_program(program1, table1);
+
+  if(linker->flags & LINK_NORMALIZE)
+    program1 = normalize_program(program1, &linker->normstats);
+
+  if(!collect) {
+    /* Write rules immediately and free the memory */
+
+    int failed = 0;
+
+    if(linker->style == STYLE_ASPIF) {
+      reloc_program(program1, table1);
+      linker->priority = write_aspif_program(linker->out, program1,
+					     linker->priority);
+      failed = (linker->priority < 0);
+    } else
+      failed = spit_program(linker->style, linker->out, program1, table1);
+
+    free_program(program1);
+    program1 = NULL;
+
+    if(failed) {
+      free(syms);
+      return linker_fail(linker, LINK_ERROR_OUTPUT,
+			 "cannot write rules in output style %i",
+			 linker->style);
+    }
+  }
+
+  transfer_status_bits(table1, linker->table); /* MARK_TRUE/FALSE/HEADOCC */
+
+  if(size1>0) {
+    /* Append table1 after the linked table */
+
+    table1 = compress_symbol_table(table1, size1, linker->size);
+    attach_atoms_to_names(table1);
+    linker->table = append_table(linker->table, table1);
+
+    linker->size += size1;
+
+  } else
+    free_linker_tables(table1);
+
+  if(collect)
+    linker->program = append_rules(linker->program, program1);
+
+  linker->number *= number1;
+
+  record_module_names(linker, sym_cnt, syms);
+  free(syms);
+
+  return LINK_OK;
+}
+
+/* Read a single module in the SMODELS or aspif format */
+
+int link_stream(LINKER *linker, FILE *in)
+{
+  RULE *program = NULL;
+  ATAB *table = NULL;
+  int number = 1;
+  char message[ASPIF_ERROR_SIZE];
+
+  if(linker_refuses(linker))
+    return LINK_ERROR_STATE;
+
+  if(is_aspif(in)) {
+    program = read_aspif(in, &table, message);
+    if(!table)
+      return linker_fail(linker, LINK_ERROR_INPUT, "aspif: %s", message);
+  } else {
+    program = read_program(in);
+    table = read_symbols(in);
+    number = read_compute_statement(in, table);
+  }
+
+  return link_program(linker, program, table, number);
+}
+
+/* ------------------------- Checking SMODELS text ------------------------ */
+
+/* liblp gives up the whole process on malformed SMODELS input; therefore
+   modules in buffers are checked by a strict tokenizer before parsing */
+
+/* liblp allocates tables up to the largest atom number of a module, which
+   is therefore bounded by the length of the module (with some slack for
+   sparse numbering) */
+
+#define SMODELS_ATOM_SLACK (1<<20)
+#define SMODELS_ATOM_RATIO 64
+
+typedef struct smodelsscan {
+  const char *text;
+  size_t len;
+  size_t pos;
+  int atom_max;         /* The largest atom number accepted */
+  int large;            /* An atom number exceeding atom_max (if any) */
+} SMODELSSCAN;
+
+void skip_smodels_space(SMODELSSCAN *sc)
+{
+  while(sc->pos < sc->len && isspace((unsigned char)sc->text[sc->pos]))
+    sc->pos++;
+
+  return;
+}
+
+int at_smodels_separator(SMODELSSCAN *sc)
+{
+  return sc->pos == sc->len || isspace((unsigned char)sc->text[sc->pos]);
+}
+
+/* A non-negative number (int) delimited by white space */
+
+int scan_smodels_number(SMODELSSCAN *sc, int *value)
+{
+  long n = 0;
+
+  skip_smodels_space(sc);
+
+  if(sc->pos == sc->len || !isdigit((unsigned char)sc->text[sc->pos]))
+    return -1;
+
+  while(sc->pos < sc->len && isdigit((unsigned char)sc->text[sc->pos])) {
+    n = 10*n + (sc->text[sc->pos++]-'0');
+    if(n > INT_MAX)
+      return -1;
+  }
+
+  if(!at_smodels_separator(sc))
+    return -1;
+
+  *value = (int)n;
+
+  return 0;
+}
+
+int scan_smodels_word(SMODELSSCAN *sc, const char *word)
+{
+  size_t n = strlen(word);
+
+  skip_smodels_space(sc);
+
+  if(sc->len-sc->pos < n || strncmp(&sc->text[sc->pos], word, n) != 0)
+    return -1;
+
+  sc->pos += n;
+
+  return at_smodels_separator(sc) ? 0 : -1;
+}
+
+/* An atom number (or 0) within the limit */
+
+int scan_smodels_atom(SMODELSSCAN *sc, int *atom)
+{
+  if(scan_smodels_number(sc, atom))
+    return -1;
+
+  if(*atom > sc->atom_max) {
+    sc->large = *atom;
+    return -1;
+  }
+
+  return 0;
+}
+
+/* Atoms are positive; with cnt < 0, read them up to 0 */
+
+int scan_smodels_atoms(SMODELSSCAN *sc, int cnt)
+{
+  int atom = 0;
+
+  while(cnt) {
+    if(scan_smodels_atom(sc, &atom))
+      return -1;
+    if(cnt < 0 && atom == 0)
+      return 0;
+    if(atom == 0)
+      return -1;
+    if(cnt > 0)
+      cnt--;
+  }
+
+  return 0;
+}
+
+int scan_smodels_rule(SMODELSSCAN *sc, int type)
+{
+  int head_cnt = 1;
+  int cnt = 0;
+  int neg_cnt = 0;
+  int value = 0;
+  int i = 0;
+
+  switch(type) {
+  case TYPE_BASIC:
+  case TYPE_CONSTRAINT:
+  case TYPE_WEIGHT:
+    if(scan_smodels_atoms(sc, 1))
+      return -1;
+    break;
+
+  case TYPE_CHOICE:
+  case TYPE_DISJUNCTIVE:
+    if(scan_smodels_number(sc, &head_cnt) || scan_smodels_atoms(sc, head_cnt))
+      return -1;
+    break;
+
+  case TYPE_INTEGRITY:
+    break;
+
+  case TYPE_OPTIMIZE:
+    if(scan_smodels_number(sc, &value) || value)
+      return -1;
+    break;
+
+  default:
+    return -1;
+  }
+
+  if(type == TYPE_WEIGHT && scan_smodels_number(sc, &value))
+    return -1;
+
+  if(scan_smodels_number(sc, &cnt) || scan_smodels_number(sc, &neg_cnt)
+     || neg_cnt > cnt)
+    return -1;
+
+  if(type == TYPE_CONSTRAINT && scan_smodels_number(sc, &value))
+    return -1;
+
+  if(scan_smodels_atoms(sc, cnt))
+    return -1;
+
+  if(type == TYPE_WEIGHT || type == TYPE_OPTIMIZE)
+    for(i=0; i<cnt; i++)
+      if(scan_smodels_number(sc, &value))
+	return -1;
+
+  return 0;
+}
+
+/* Names extend to the end of the line */
+
+int scan_smodels_name(SMODELSSCAN *sc)
+{
+  while(sc->pos < sc->len
+	&& (sc->text[sc->pos] == ' ' || sc->text[sc->pos] == '\t'))
+    sc->pos++;
+
+  if(at_smodels_separator(sc))
+    return -1;
+
+  while(sc->pos < sc->len && sc->text[sc->pos] != '\n')
+    sc->pos++;
+
+  return 0;
+}
+
+/*
+ * scan_smodels_module -- Scan a module in the SMODELS format: rules,
+ * symbols, the compute statement (B+, B-, and optionally E), and the
+ * number of models; returns a description of the first error (or NULL)
+ */
+
+char *scan_smodels_module(SMODELSSCAN *sc, int *rules)
+{
+  int type = 0;
+  int atom = 0;
+
+  while(1) {
+    (*rules)++;
+    if(scan_smodels_number(sc, &type))
+      return "rule type expected (rule %i)";
+    if(type == 0)
+      break;
+    if(scan_smodels_rule(sc, type))
+      return "malformed rule %i";
+  }
+
+  while(1) {
+    if(scan_smodels_atom(sc, &atom))
+      return "atom number expected in symbols";
+    if(atom == 0)
+      break;
+    if(scan_smodels_name(sc))
+      return "name expected for an atom";
+  }
+
+  if(scan_smodels_word(sc, "B+") || scan_smodels_atoms(sc, -1))
+    return "malformed B+ section";
+
+  if(scan_smodels_word(sc, "B-") || scan_smodels_atoms(sc, -1))
+    return "malformed B- section";
+
+  skip_smodels_space(sc);
+  if(sc->pos < sc->len && sc->text[sc->pos] == 'E'
+     && (scan_smodels_word(sc, "E") || scan_smodels_atoms(sc, -1)))
+    return "malformed E section";
+
+  if(scan_smodels_number(sc, &atom))
+    return "number of models expected";
+
+  return NULL;
+}
+
+/* Check that the text starts with a module before liblp parses it */
+
+int check_smodels_module(LINKER *linker, const char *text, size_t len)
+{
+  SMODELSSCAN sc;
+  char *error = NULL;
+  char message[64];
+  int rules = 0;
+
+  sc.text = text;
+  sc.len = len;
+  sc.pos = 0;
+  sc.large = 0;
+  sc.atom_max = (len < (size_t)(INT_MAX-SMODELS_ATOM_SLACK)/SMODELS_ATOM_RATIO)
+    ? SMODELS_ATOM_SLACK + SMODELS_ATOM_RATIO*(int)len : INT_MAX;
+
+  error = scan_smodels_module(&sc, &rules);
+
+  if(sc.large)
+    return linker_fail(linker, LINK_ERROR_INPUT,
+		       "smodels: atom number %i exceeds %i",
+		       sc.large, sc.atom_max);
+  if(error) {
+    sprintf(message, error, rules);  /* Only rule errors refer to rules */
+    return linker_fail(linker, LINK_ERROR_INPUT, "smodels: %s", message);
+  }
+
+  return LINK_OK;
+}
+
+int skip_module_space(FILE *in)
+{
+  int c = 0;
+
+  while((c = getc(in)) != EOF && isspace(c))
+    ;
+
+  if(c != EOF)
+    ungetc(c, in);
+
+  return c;
+}
+
+/* Read modules one after another until the end of the buffer */
+
+int link_buffer(LINKER *linker, const char *buf, size_t len)
+{
+  FILE *in = NULL;
+  int status = LINK_OK;
+
+  if(linker_refuses(linker))
+    return LINK_ERROR_STATE;
+
+  if(!len || (in = fmemopen((void *)buf, len, "r")) == NULL)
+    return linker_fail(linker, LINK_ERROR_INPUT, "no module in the buffer");
+
+  if(skip_module_space(in) == EOF) {
+    fclose(in);
+    return linker_fail(linker, LINK_ERROR_INPUT, "no module in the buffer");
+  }
+
+  do {
+    long pos = ftell(in);
+
+    if(!is_aspif(in)
+       && (status = check_smodels_module(linker, buf+pos, len-pos)))
+      break;
+    status = link_stream(linker, in);
+  } while(status == LINK_OK && skip_module_space(in) != EOF);
+
+  fclose(in);
+
+  return status;
+}
+
+/* ------------------------- Module conditions ----------------------------- */
+
+int check_module_conditions(LINKER *linker, char *cachefile)
+{
+  OCCTAB *occtab = NULL;
+  unsigned long long hash = 0;
+  int cached = 0;
+
+  if(linker->status)
+    return LINK_ERROR_STATE;
+
+  if(!(linker->flags & LINK_MODULAR) || !linker_collects(linker))
+    return LINK_OK;
+
+  activate_linker(linker);
+
+  /* Form the dependency graph (unless cached) */
+
+  occtab = initialize_occurrences(linker->table);
+  if(cachefile) {
+    hash = hash_program(linker->program, linker->table);
+    cached = load_analysis(cachefile, hash, linker->program, occtab,
+			   linker->size);
+  }
+  if(!cached)
+    compute_occurrences(linker->program, occtab, 0);
+
+  /* Calculate strongly connected components and check module conditions */
+
+  if(!(cached & CACHE_MODULAR)) {
+    char *msg = NULL;
+    size_t len = 0;
+    FILE *err = open_memstream(&msg, &len);
+    int errors = 0;
+
+    if(cached)
+      reset_sccs(occtab);
+    errors = compute_joint_sccs(occtab, linker->size, err);
+    if(err)
+      fclose(err);
+
+    if(errors) {
+      if(len && msg[len-1] == '\n')
+	msg[len-1] = '\0';
+      linker_fail(linker, LINK_ERROR_MODULE, "%s", msg ? msg : "module error");
+      free(msg);
+      free_occurrences(occtab);
+      return LINK_ERROR_MODULE;
+    }
+
+    free(msg);
+
+    if(cachefile)
+      save_analysis(cachefile, hash, linker->program, occtab, linker->size,
+		    CACHE_MODULAR);
+  }
+
+  free_occurrences(occtab);
+
+  return LINK_OK;
+}
+
+/* ------------------------- Access to the result -------------------------- */
+
+RULE *linked_program(LINKER *linker)
+{
+  return linker->program;
+}
+
+ATAB *linked_table(LINKER *linker)
+{
+  return linker->table;
+}
+
+void set_linked_program(LINKER *linker, RULE *program, ATAB *table)
+{
+  linker->program = program;
+  linker->table = table;
+
+  if(live_linker_cnt > 1)
+    map_linked_names(linker);
+
+  return;
+}
+
+int linked_atom_count(LINKER *linker)
+{
+  return linker->size;
+}
+
+int linked_models(LINKER *linker)
+{
+  return linker->number;
+}
+
+int linked_priority(LINKER *linker)
+{
+  return linker->priority;
+}
+
+NORMSTATS *linked_normstats(LINKER *linker)
+{
+  return &linker->normstats;
+}
+
+/* ------------------------- Writing the result ---------------------------- */
+
+void make_linked_table_contiguous(LINKER *linker)
+{
+  if(linker->table && linker->table->next) {
+    linker->table = make_contiguous(linker->table);
+
+    /* The pieces have been replaced */
+
+    if(live_linker_cnt > 1)
+      map_linked_names(linker);
+    else
+      attach_atoms_to_names(linker->table);
+  }
+
+  return;
+}
+
+int write_linked_symbols(LINKER *linker, FILE *out)
+{
+  if(linker->status)
+    return LINK_ERROR_STATE;
+
+  activate_linker(linker);
+  make_linked_table_contiguous(linker);
+
+  write_symbols(STYLE_SMODELS, out, linker->table);
+
+  if(ferror(out))
+    return linker_fail(linker, LINK_ERROR_OUTPUT,
+		       "cannot write the symbols");
+
+  return LINK_OK;
+}
+
+int write_linked_program(LINKER *linker, FILE *out)
+{
+  ATAB *table = NULL;
+
+  if(linker->status)
+    return LINK_ERROR_STATE;
+
+  activate_linker(linker);
+  make_linked_table_contiguous(linker);
+  table = linker->table;
+
+  if(linker_collects(linker))
+    write_program(STYLE_SMODELS, out, linker->program, table);
+  fprintf(out, "0\n");
+
+  write_symbols(STYLE_SMODELS, out, table);
+  fprintf(out, "0\n");
+
+  fprintf(out, "B+\n");
+  write_compute_statement(STYLE_SMODELS, out, table, MARK_TRUE);
+  fprintf(out, "0\n");
+
+  fprintf(out, "B-\n");
+  write_compute_statement(STYLE_SMODELS, out, table, MARK_FALSE);
+  fprintf(out, "0\n");
+
+  if(!(linker->flags & LINK_MARK_INPUT))
+    reset_input_atoms(table);
+  fprintf(out, "E\n");
+  write_compute_statement(STYLE_SMODELS, out, table, MARK_INPUT);
+  fprintf(out, "0\n");
+
+  fprintf(out, "%i\n", linker->number);
+
+  if(ferror(out))
+    return linker_fail(linker, LINK_ERROR_OUTPUT,
+		       "cannot write the linked program");
+
+  return LINK_OK;
+}
+
+int finalize_into_buffer(LINKER *linker, char **buf, size_t *len)
+{
+  FILE *out = NULL;
+  int status = LINK_OK;
+
+  *buf = NULL;
+  *len = 0;
+
+  if((status = check_module_conditions(linker, NULL)))
+    return status;
+
+  if((out = open_memstream(buf, len)) == NULL)
+    return linker_fail(linker, LINK_ERROR_OUTPUT, "cannot allocate a buffer");
+
+  status = write_linked_program(linker, out);
+  fclose(out);
+  linker->finalized = -1;
+
+  if(status) {
+    free(*buf);
+    *buf = NULL;
+    *len = 0;
+  }
+
+  return status;
+}
+
+int finalize_into_fd(LINKER *linker, int fd)
+{
+  FILE *out = NULL;
+  int status = LINK_OK;
+  int fd2 = 0;
+
+  if((status = check_module_conditions(linker, NULL)))
+    return status;
+
+  if((fd2 = dup(fd)) < 0 || (out = fdopen(fd2, "w")) == NULL) {
+    if(fd2 >= 0)
+      close(fd2);
+    return linker_fail(linker, LINK_ERROR_OUTPUT,
+		       "cannot write to descriptor %i", fd);
+  }
+
+  status = write_linked_program(linker, out);
+  if(fclose(out) && !status)
+    status = linker_fail(linker, LINK_ERROR_OUTPUT,
+			 "cannot write to descriptor %i", fd);
+  linker->finalized = -1;
+
+  return status;
+}
+
+/* ------------------------- Output routines shared with LPCAT ------------ */
+
+void spit_atom(int style, FILE *out, int atom, ATAB *table)
+{
+  int offset = table->offset;
+  int count = table->count;
+  int shift = table->shift;
+  int *others = table->others;
+  int atom2 = others[atom-offset];
+
+  if(style == STYLE_SMODELS)
+    fprintf(out, " %i", atom2+shift);
+  else {
+    SYMBOL **symbols = table->names;
+    SYMBOL *sym = symbols[atom-offset];
+
+    if(sym)
+      write_name(out, sym, table->prefix, table->postfix);
+    else
+      fprintf(out, "_%i", atom2+shift);
+  }
+
+  return;
+}
+
+void spit_literal_list(int style, FILE *out, char *separator,
+		       int pos_cnt, int *pos,
+		       int neg_cnt, int *neg,
+		       int *weight, ATAB *table)
+{
+  int *scan = NULL;
+  int *last = NULL;
+  int *wscan = weight;
+  int *wlast = &weight[pos_cnt+neg_cnt];
+
+  for(scan = neg, last = &neg[neg_cnt];
+      scan != last; ) {
+    if(style == STYLE_READABLE)
+      fprintf(out, "not ");
+    spit_atom(style, out, *scan, table);
+    if(wscan && (style == STYLE_READABLE))
+      fprintf(out, "=%i", *(wscan++));
+    scan++;
+    if(style == STYLE_READABLE)
+      if(scan != last || pos_cnt)
+	fprintf(out, "%s", separator);
+  }
+
+  for(scan = pos, last = &pos[pos_cnt];
+      scan != last; ) {
+    spit_atom(style, out, *scan, table);
+    if(wscan && (style == STYLE_READABLE))
+      fprintf(out, "=%i", *(wscan++));
+    scan++;
+    if(style == STYLE_READABLE)
+      if(scan != last)
+	fprintf(out, "%s", separator);
+  }
+
+  if(wscan && (style == STYLE_SMODELS))
+    while(wscan != wlast)
+      fprintf(out, " %i", *(wscan++));
+
+  return;
+}
+
+void spit_basic(int style, FILE *out, RULE *rule, ATAB *table)
+{
+  int *scan = NULL;
+  int *last = NULL;
+  int pos_cnt = 0;
+  int neg_cnt = 0;
+
+  BASIC_RULE *basic = rule->data.basic;
+
+  if(style == STYLE_SMODELS)
+    fprintf(out, "1");
+
+  spit_atom(style, out, basic->head, table);
+
+  pos_cnt = basic->pos_cnt;
+  neg_cnt = basic->neg_cnt;
+
+  if(style == STYLE_SMODELS)
+    fprintf(out, " %i %i", (pos_cnt+neg_cnt), neg_cnt);
+
+  if(pos_cnt || neg_cnt) {
+    if(style == STYLE_READABLE)
+      fprintf(out, " :- ");
+
+    spit_literal_list(style, out, ", ",
+		       pos_cnt, basic->pos,
+		       neg_cnt, basic->neg,
+		       NULL, table);
+  }
+
+  if(style == STYLE_READABLE)
+    fprintf(out, ".");
+  fprintf(out, "\n");
+
+  return;
+}
+
+void spit_constraint(int style, FILE *out, RULE *rule, ATAB *table)
+{
+  int pos_cnt = 0;
+  int neg_cnt = 0;
+  int bound = 0;
+
+  CONSTRAINT_RULE *constraint = rule->data.constraint;
+
+  if(style == STYLE_SMODELS)
+    fprintf(out, "2");
+
+  spit_atom(style, out, constraint->head, table);
+
+  pos_cnt = constraint->pos_cnt;
+  neg_cnt = constraint->neg_cnt;
+  bound = constraint->bound;
+
+  if(style == STYLE_SMODELS)
+    fprintf(out, " %i %i %i", (pos_cnt+neg_cnt), neg_cnt, bound);
+
+  if(style == STYLE_READABLE)
+    fprintf(out, " :- %i {", bound);
+
+  if(pos_cnt || neg_cnt)
+    spit_literal_list(style, out, ", ",
+		       pos_cnt, constraint->pos,
+		       neg_cnt, constraint->neg,
+		       NULL, table);
+
+  if(style == STYLE_READABLE)
+    fprintf(out, "}.");
+
+  fprintf(out, "\n");
+
+  return;
+}
+
+void spit_choice(int style, FILE *out, RULE *rule, ATAB *table)
+{
+  int head_cnt = 0;
+  int pos_cnt = 0;
+  int neg_cnt = 0;
+  char *separator = ", ";
+
+  CHOICE_RULE *choice = rule->data.choice;
+  head_cnt = choice->head_cnt;
+  pos_cnt = choice->pos_cnt;
+  neg_cnt = choice->neg_cnt;
+
+  if(style == STYLE_SMODELS)
+    fprintf(out, "3 %i", head_cnt);
+  else if(style == STYLE_READABLE)
+    fprintf(out, "{");
+
+  spit_literal_list(style, out, separator,
+		     head_cnt, choice->head,
+		     0, NULL,
+		     NULL, table);
+
+  if(style == STYLE_READABLE)
+    fprintf(out, "}");
+
+  if(style == STYLE_SMODELS)
+    fprintf(out, " %i %i", (pos_cnt+neg_cnt), neg_cnt);
+
+  if(pos_cnt || neg_cnt) {
+    if(style == STYLE_READABLE)
+      fprintf(out, " :- ");
+
+    spit_literal_list(style, out, ", ",
+		       pos_cnt, choice->pos,
+		       neg_cnt, choice->neg,
+		       NULL, table);
+  }
+
+  if(style == STYLE_READABLE)
+    fprintf(out, ".");
+  fprintf(out, "\n");
+
+  return;
+}
+
+void spit_integrity(int style, FILE *out, RULE *rule, ATAB *table)
+{
+  int *scan = NULL;
+  int *last = NULL;
+  int pos_cnt = 0;
+  int neg_cnt = 0;
+
+  INTEGRITY_RULE *integrity = rule->data.integrity;
+
+  if(style == STYLE_SMODELS)
+    fprintf(out, "4");
+
+  pos_cnt = integrity->pos_cnt;
+  neg_cnt = integrity->neg_cnt;
+
+  if(style == STYLE_SMODELS)
+    fprintf(out, " %i %i", (pos_cnt+neg_cnt), neg_cnt);
+
+  if(pos_cnt || neg_cnt) {
+    if(style == STYLE_READABLE)
+      fprintf(out, " :- ");
+
+    spit_literal_list(style, out, ", ",
+		       pos_cnt, integrity->pos,
+		       neg_cnt, integrity->neg,
+		       NULL, table);
+  }
+
+  if(style == STYLE_READABLE)
+    fprintf(out, ".");
+  fprintf(out, "\n");
+
+  return;
+}
+
+void spit_weight(int style, FILE *out, RULE *rule, ATAB *table)
+{
+  int pos_cnt = 0;
+  int neg_cnt = 0;
+  int bound = 0;
+
+  WEIGHT_RULE *weight = rule->data.weight;
+
+  if(style == STYLE_SMODELS)
+    fprintf(out, "5");
+
+  spit_atom(style, out, weight->head, table);
+
+  pos_cnt = weight->pos_cnt;
+  neg_cnt = weight->neg_cnt;
+  bound = weight->bound;
+
+  if(style == STYLE_SMODELS)
+    fprintf(out, " %i %i %i", bound, (pos_cnt+neg_cnt), neg_cnt);
+
+  if(style == STYLE_READABLE)
+    fprintf(out, " :- %i [", bound);
+
+  if(pos_cnt || neg_cnt)
+    spit_literal_list(style, out, ", ",
+		       pos_cnt, weight->pos,
+		       neg_cnt, weight->neg,
+		       weight->weight, table);
+
+  if(style == STYLE_READABLE)
+    fprintf(out, "].");
+  fprintf(out, "\n");
+
+  return;
+}
+
+void spit_optimize(int style, FILE *out, RULE *rule, ATAB *table)
+{
+  int pos_cnt = 0;
+  int neg_cnt = 0;
+
+  OPTIMIZE_RULE *optimize = rule->data.optimize;
+
+  if(style == STYLE_SMODELS)
+    fprintf(out, "6 0");
+
+  pos_cnt = optimize->pos_cnt;
+  neg_cnt = optimize->neg_cnt;
+
+  if(style == STYLE_SMODELS)
+    fprintf(out, " %i %i", (pos_cnt+neg_cnt), neg_cnt);
+
+  if(pos_cnt || neg_cnt) {
+    if(style == STYLE_READABLE)
+      fprintf(out, "minimize [");
+
+    spit_literal_list(style, out, ", ",
+		       pos_cnt, optimize->pos,
+		       neg_cnt, optimize->neg,
+		       optimize->weight, table);
+  }
+
+  if(style == STYLE_READABLE)
+    fprintf(out, "].");
+  fprintf(out, "\n");
+
+  return;
+}
+
+void spit_disjunctive(int style, FILE *out, RULE *rule, ATAB *table)
+{
+  int head_cnt = 0;
+  int pos_cnt = 0;
+  int neg_cnt = 0;
+  char *separator = ", ";
+
+  DISJUNCTIVE_RULE *disjunctive = rule->data.disjunctive;
+  head_cnt = disjunctive->head_cnt;
+  pos_cnt = disjunctive->pos_cnt;
+  neg_cnt = disjunctive->neg_cnt;
+
+  if(style == STYLE_SMODELS)
+    fprintf(out, "8 %i", head_cnt);
+  else if(style == STYLE_READABLE)
+    fprintf(out, "{");
+
+  spit_literal_list(style, out, separator,
+		     head_cnt, disjunctive->head,
+		     0, NULL,
+		     NULL, table);
+
+  if(style == STYLE_READABLE)
+    fprintf(out, "}");
+
+  if(style == STYLE_SMODELS)
+    fprintf(out, " %i %i", (pos_cnt+neg_cnt), neg_cnt);
+
+  if(pos_cnt || neg_cnt) {
+    if(style == STYLE_READABLE)
+      fprintf(out, " :- ");
+
+    spit_literal_list(style, out, ", ",
+		       pos_cnt, disjunctive->pos,
+		       neg_cnt, disjunctive->neg,
+		       NULL, table);
+  }
+
+  if(style == STYLE_READABLE)
+    fprintf(out, ".");
+  fprintf(out, "\n");
+
+  return;
+}
+
+int spit_rule(int style, FILE *out, RULE *rule, ATAB *table)
+{
+  switch(rule->type) {
+  case TYPE_BASIC:
+    spit_basic(style, out, rule, table);
+    break;
+
+  case TYPE_CONSTRAINT:
+    spit_constraint(style, out, rule, table);
+    break;
+
+  case TYPE_CHOICE:
+    spit_choice(style, out, rule, table);
+    break;
+
+  case TYPE_INTEGRITY:
+    spit_integrity(style, out, rule, table);
+    break;
+
+  case TYPE_WEIGHT:
+    spit_weight(style, out, rule, table);
+    break;
+
+  case TYPE_OPTIMIZE:
+    spit_optimize(style, out, rule, table);
+    break;
+
+  case TYPE_DISJUNCTIVE:
+    spit_disjunctive(style, out, rule, table);
+    break;
+
+  default:
+    return -1;   /* Unknown rule type */
+  }
+
+  return 0;
+}
+
+/* Returns -1 for unknown styles and rule types, or if the first symbol
+   table is not contiguous (0 otherwise) */
+
+int spit_program(int style, FILE *out, RULE *rule, ATAB *table)
+{
+  if(style != STYLE_READABLE && style != STYLE_SMODELS)
+    return -1;
+
+  if(!table || table->next)
+    return -1;
+
+  while(rule) {
+    if(spit_rule(style, out, rule, table))
+      return -1;
+    rule = rule->next;
+  }
+  return 0;
+}
+
+void transfer_status_bits(ATAB *table1, ATAB *table2)
+{
+  ATAB *scan = table1;
+  int i = 0;
+
+  /* Presumes a previous call to attach_atoms_to_names(table2) */
+
+  while(scan) {
+    int count = scan->count;
+    int offset = scan->offset;
+    SYMBOL **names = scan->names;
+
+    for(i=1; i<=count; i++) {
+      int atom = i+offset;
+      SYMBOL *sym = names[i];
+
+      if(sym) {   /* The atom has a symbolic name */
+
+	ATAB *other = sym->info.table;    /* Relevant piece */
+	int atom2 = sym->info.atom;
+	
+	if(atom2 && other) {
+	  int j = atom2 - other->offset;  /* Calculate index */
+
+	  (other->statuses)[j] |=
+	    ((scan->statuses)[i] & (MARK_TRUE_OR_FALSE|MARK_HEADOCC));
+
+	}
+      }
+    }
+    scan = scan->next;
+  }
+
+  return;
+}
+
+void reset_input_atoms(ATAB *table)
+{
+  while(table) {
+    int count = table->count;
+    SYMBOL **names = table->names;
+    int *statuses = table->statuses;
+    int i = 0;
+
+    for(i = 1; i <= count; i++)
+
+      /* Reset the input status if defining rules exist */
+      if(names[i] && (statuses[i] & MARK_HEADOCC))
+	statuses[i] &= ~MARK_INPUT;
+
+    table = table->next;
+  }
+
+  return;
+}
@@ -0,0 +1,100 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Linking of program modules (the link loop of LPCAT as a library)
+ *
+ * (c) 2026 Tomi Janhunen
+ *
+ * A linker is created by new_linker() and fed with modules using
+ * link_buffer(), link_stream(), or link_program(). The linked program is
+ * obtained by finalize_into_buffer() or finalize_into_fd(). Errors are
+ * reported by negative return values and explained by linker_error();
+ * after an error, the linker refuses further modules.
+ *
+ * Since the symbol table of liblp is global, the symbols are attached to
+ * the atoms of one linker at a time; several linkers may coexist, but
+ * calls on them must not run concurrently (see server.c). Coexisting
+ * linkers keep maps from symbols to their atoms, so that linking a module
+ * attaches only the symbols of the module. Symbols are never removed from
+ * liblp: every distinct name linked stays until the process exits, also
+ * after free_linker(). Modules in buffers are checked before liblp
+ * parses them, so that malformed input, including atom numbers far beyond
+ * the length of the module, gives LINK_ERROR_INPUT; for streams, SMODELS
+ * parse errors within liblp remain fatal.
+ */
+
+/* Version information */
+
+#define _LINKER_H_RCSFILE  "$RCSfile: linker.h,v $"
+#define _LINKER_H_DATE     "$Date: 2026/10/18 18:00:00 $"
+#define _LINKER_H_REVISION "$Revision: 1.1 $"
+
+extern void _version_linker_c();
+
+/* Flags for new_linker() */
+
+#define LINK_COLLECT    1   /* Keep rules in memory (lpcat -c) */
+#define LINK_MODULAR    2   /* Check module conditions (lpcat -m) */
+#define LINK_MARK_INPUT 4   /* Mark input atoms (lpcat -i) */
+#define LINK_NORMALIZE  8   /* Normalize rules (lpcat -n) */
+#define LINK_LENIENT   16   /* Only warn about doubly defined atoms */
+
+/* Return values */
+
+#define LINK_OK            0
+#define LINK_ERROR_INPUT  -1   /* Unreadable module */
+#define LINK_ERROR_MODULE -2   /* Module conditions violated */
+#define LINK_ERROR_OUTPUT -3   /* Linked program cannot be written */
+#define LINK_ERROR_STATE  -4   /* Earlier error or already finalized */
+
+typedef struct linker LINKER;
+
+/* Linking modules */
+
+extern LINKER *new_linker(int flags, int first_atom);
+extern void free_linker(LINKER *linker);
+extern void set_linker_output(LINKER *linker, FILE *out, int style);
+extern int link_program(LINKER *linker, RULE *program, ATAB *table,
+			int number);
+extern int link_stream(LINKER *linker, FILE *in);
+extern int link_buffer(LINKER *linker, const char *buf, size_t len);
+extern int check_module_conditions(LINKER *linker, char *cachefile);
+extern const char *linker_error(LINKER *linker);
+
+/* Access to the result */
+
+extern RULE *linked_program(LINKER *linker);
+extern ATAB *linked_table(LINKER *linker);
+extern void set_linked_program(LINKER *linker, RULE *program, ATAB *table);
+extern int linked_atom_count(LINKER *linker);
+extern int linked_models(LINKER *linker);
+extern int linked_priority(LINKER *linker);
+extern NORMSTATS *linked_normstats(LINKER *linker);
+
+extern int write_linked_symbols(LINKER *linker, FILE *out);
+extern int write_linked_program(LINKER *linker, FILE *out);
+extern int finalize_into_buffer(LINKER *linker, char **buf, size_t *len);
+extern int finalize_into_fd(LINKER *linker, int fd);
+
+/* Output routines shared with LPCAT */
+
+extern int spit_program(int style, FILE *out, RULE *program, ATAB *table);
+extern void transfer_status_bits(ATAB *table1, ATAB *table2);
+extern void reset_input_atoms(ATAB *table);
@@ -36,6 +36,16 @@
 #include "io.h"
 #include "scc.h"
 #include "relocate.h"
+#include "normalize.h"
+#include "simplify.h"
+#include "equivalence.h"
+#include "slice.h"
+#include "renumber.h"
+#include "cache.h"
+#include "aspif.h"
+#include "linker.h"
+#include "server.h"
+#include "multiplex.h"
 
 void _version_lpcat_c()
 {
@@ -50,6 +60,16 @@ void _version_lpcat_c()
   _version_output_c();
   _version_scc_c();
   _version_relocate_c();
+  _version_normalize_c();
+  _version_simplify_c();
+  _version_equivalence_c();
+  _version_slice_c();
+  _version_renumber_c();
+  _version_cache_c();
+  _version_aspif_c();
+  _version_linker_c();
+  _version_server_c();
+  _version_multiplex_c();
 }
 
 void usage()
@@ -60,25 +80,48 @@ void usage()
   fprintf(stderr, "   -h or --help -- print help message\n");
   fprintf(stderr, "   --version -- print version information\n");
   fprintf(stderr, "   -v -- verbose mode (human readable)\n");
+  fprintf(stderr, "   --aspif -- output in the aspif format\n");
+  fprintf(stderr, "         (default if the first input is in aspif)\n");
   fprintf(stderr, "   -c -- collect the entire program in memory\n");
   fprintf(stderr, "   -f -- read file names from a file\n");
   fprintf(stderr, "   -r -- read modules recursively until EOF\n");
+  fprintf(stderr, "   -p -- read the files (pipes, FIFOs) concurrently and\n");
+  fprintf(stderr, "         link modules as they arrive (presumes -r)\n");
+  fprintf(stderr, "   -p=files\n");
+  fprintf(stderr, "      -- as -p, but modules arriving together are linked\n");
+  fprintf(stderr, "         in the order of the files\n");
   fprintf(stderr, "   -m -- check module conditions\n");
   fprintf(stderr, "         (also SCCs are checked if -c is given)\n");
   fprintf(stderr, "   -i -- mark input atoms (having no defining rules)\n");
+  fprintf(stderr, "   -n -- normalize rules (sort and merge literals)\n");
+  fprintf(stderr, "   -w -- simplify using the well-founded model\n");
+  fprintf(stderr, "         (presumes -c)\n");
+  fprintf(stderr, "   -e -- collapse equivalent atoms (presumes -c)\n");
   fprintf(stderr, "   -a=<number>\n");
   fprintf(stderr, "      -- set the first possible atom number\n");
   fprintf(stderr, "   -s=<symbol file>\n");
   fprintf(stderr, "      -- print a dummy program with symbol names\n");
+  fprintf(stderr, "   -q=<query file>\n");
+  fprintf(stderr, "      -- keep only rules relevant to the atoms named\n");
+  fprintf(stderr, "         in the file and the compute statement\n");
+  fprintf(stderr, "         (presumes -c)\n");
+  fprintf(stderr, "   -o=<order>\n");
+  fprintf(stderr, "      -- renumber atoms for locality (presumes -c):\n");
+  fprintf(stderr, "         scc (topological order of SCCs), bfs\n");
+  fprintf(stderr, "         (breadth-first), or module (default)\n");
+  fprintf(stderr, "   -k=<cache file>\n");
+  fprintf(stderr, "      -- reuse SCCs from the file or save them there\n");
+  fprintf(stderr, "         (presumes -m and -c)\n");
+  fprintf(stderr, "   -d=<socket>\n");
+  fprintf(stderr, "      -- serve link sessions on a Unix domain socket\n");
+  fprintf(stderr, "         (only -m, -i, -n, -a, and -t apply; see server.h)\n");
+  fprintf(stderr, "   -t=<number>\n");
+  fprintf(stderr, "      -- number of sessions served concurrently by -d\n");
   fprintf(stderr, "\n");
 
   return;
 }
 
-void spit_program(int style, FILE *out, RULE *program, ATAB *table);
-void transfer_status_bits(ATAB *table1, ATAB *table2);
-void reset_input_atoms(ATAB *table);
-
 int main(int argc, char **argv)
 {
   char **files = (char **)malloc(argc*sizeof(char *));
@@ -87,26 +130,29 @@ int main(int argc, char **argv)
   FILE *in = NULL;
 
   RULE *program1 = NULL;
+  char aspif_message[ASPIF_ERROR_SIZE];
   ATAB *table1 = NULL;
-  int size1 = 0;
   int number1 = 0;
-  int module = 0;
 
+  LINKER *linker = NULL;
   RULE *program2 = NULL;
   ATAB *table2 = NULL;
   int size2 = 0;
-  OCCTAB *occtab2 = NULL;
-  int number2 = 1;
 
   char *file = NULL;
   char *metafile = NULL;
   char *symfile = NULL;
+  char *queryfile = NULL;
+  char *cachefile = NULL;
+  char *socketfile = NULL;
 
   FILE *meta = NULL;
   FILE *sym = NULL;
+  FILE *query = NULL;
   FILE *out = stdout;
+  MULTIPLEX *mux = NULL;
 
-  int doubly_defined = 0;
+  int started = 0;
 
   int option_help = 0;
   int option_version = 0;
@@ -116,6 +162,21 @@ int main(int argc, char **argv)
   int option_modular = 0;
   int option_mark_input = 0;
   int option_symbols = 0;
+  int option_normalize = 0;
+  int option_simplify = 0;
+  int option_equivalences = 0;
+  int option_slice = 0;
+  int option_order = ORDER_NONE;
+  int option_aspif = 0;
+  int option_threads = 4;
+  int option_multiplex = 0;
+
+  char **queries = NULL;
+  int query_cnt = 0;
+
+  SIMPSTATS simpstats = { 0, 0, 0, 0, 0, 0, 0 };
+  EQSTATS eqstats = { 0, 0, 0 };
+  SLICESTATS slicestats = { 0, 0, 0, 0 };
 
   char *arg = NULL;
   int which = 0;
@@ -134,10 +195,16 @@ int main(int argc, char **argv)
       option_version = -1;
     else if(strcmp(arg, "-v") == 0)
       option_verbose = -1;
+    else if(strcmp(arg, "--aspif") == 0)
+      option_aspif = -1;
     else if(strcmp(arg, "-c") == 0)
       option_collect = -1;
     else if(strcmp(arg, "-r") == 0)
       option_recursive = -1;
+    else if(strcmp(arg, "-p") == 0)
+      option_multiplex = MUX_ARRIVAL;
+    else if(strcmp(arg, "-p=files") == 0)
+      option_multiplex = MUX_FILES;
     else if(strcmp(arg, "-f") == 0) {
       which++;
       if(which<argc) {
@@ -154,6 +221,12 @@ int main(int argc, char **argv)
       option_modular = -1;
     else if(strcmp(arg, "-i") == 0)
       option_mark_input = -1;
+    else if(strcmp(arg, "-n") == 0)
+      option_normalize = -1;
+    else if(strcmp(arg, "-w") == 0)
+      option_simplify = -1;
+    else if(strcmp(arg, "-e") == 0)
+      option_equivalences = -1;
     else if(strncmp(arg, "-a=", 3) == 0) {
       size2 = atoi(&arg[3]) - 1;          /* The corresponding offset */
       if(size2 < 0) {
@@ -164,6 +237,26 @@ int main(int argc, char **argv)
     } else if(strncmp(arg, "-s=", 3) == 0) {
       option_symbols = -1;
       symfile = &arg[3];
+    } else if(strncmp(arg, "-q=", 3) == 0) {
+      option_slice = -1;
+      queryfile = &arg[3];
+    } else if(strncmp(arg, "-k=", 3) == 0) {
+      cachefile = &arg[3];
+    } else if(strncmp(arg, "-d=", 3) == 0) {
+      socketfile = &arg[3];
+    } else if(strncmp(arg, "-t=", 3) == 0) {
+      option_threads = atoi(&arg[3]);
+      if(option_threads < 1) {
+	fprintf(stderr, "%s: invalid number of threads %s\n",
+		program_name, &arg[3]);
+	error = -1;
+      }
+    } else if(strncmp(arg, "-o=", 3) == 0) {
+      option_order = parse_order(&arg[3]);
+      if(option_order < 0) {
+	fprintf(stderr, "%s: unknown order %s\n", program_name, &arg[3]);
+	error = -1;
+      }
     } else if(strncmp(arg, "-", 1) == 0 && strlen(arg)>1) {
       fprintf(stderr, "%s: unknown option %s\n", program_name, arg);
       error = -1;
@@ -187,12 +280,72 @@ int main(int argc, char **argv)
     exit(-1);
   }
 
+  if(option_simplify && !option_collect) {
+    fprintf(stderr, "%s: option -w presumes option -c!\n", program_name);
+    exit(-1);
+  }
+
+  if(option_equivalences && !option_collect) {
+    fprintf(stderr, "%s: option -e presumes option -c!\n", program_name);
+    exit(-1);
+  }
+
+  if(option_slice && !option_collect) {
+    fprintf(stderr, "%s: option -q presumes option -c!\n", program_name);
+    exit(-1);
+  }
+
+  if(option_order > 0 && !option_collect) {
+    fprintf(stderr, "%s: option -o presumes option -c!\n", program_name);
+    exit(-1);
+  }
+
+  if(option_verbose && option_aspif) {
+    fprintf(stderr, "%s: options -v and --aspif are incompatible!\n",
+	    program_name);
+    exit(-1);
+  }
+
+  if(cachefile && !(option_modular && option_collect)) {
+    fprintf(stderr, "%s: option -k presumes options -m and -c!\n",
+	    program_name);
+    exit(-1);
+  }
+
+  if(option_multiplex && !option_recursive) {
+    fprintf(stderr, "%s: option -p presumes option -r!\n", program_name);
+    exit(-1);
+  }
+
+  if(socketfile && (fcnt || option_verbose || option_aspif ||
+		    option_recursive || option_symbols || option_simplify ||
+		    option_equivalences || option_slice || option_order > 0 ||
+		    cachefile)) {
+    fprintf(stderr, "%s: option -d only combines with -m, -i, -n, -a, -t!\n",
+	    program_name);
+    exit(-1);
+  }
+
+  if(socketfile && !error)
+    serve_links(socketfile, option_threads,
+		(option_modular ? LINK_MODULAR : 0) |
+		(option_mark_input ? LINK_MARK_INPUT : 0) |
+		(option_normalize ? LINK_NORMALIZE : 0), size2+1);
+
   if(fcnt == 0) {
     files[fcnt] = "-";
     ismeta[fcnt] = 0;
     fcnt++;
   }
 
+  for(i=0; option_multiplex && i<fcnt; i++)
+    if(ismeta[i]) {
+      fprintf(stderr, "%s: options -p and -f are incompatible!\n",
+	      program_name);
+      exit(-1);
+    }
+  i = 0;
+
   if(error) {
     usage();
     exit(-1);
@@ -206,17 +359,46 @@ int main(int argc, char **argv)
     }
   }
 
+  if(option_slice) {
+    if((query = fopen(queryfile, "r")) == NULL) {
+      fprintf(stderr, "%s: cannot open query file %s\n",
+	      program_name, queryfile);
+      exit(-1);
+    }
+    queries = read_query(query, &query_cnt);
+    fclose(query);
+  }
+
   if(option_verbose && !option_collect) {
     fprintf(out, "%% Rules:\n");
     fprintf(out, "\n");
   }
 
+  linker = new_linker((option_collect ? LINK_COLLECT : 0) |
+		      (option_modular ? LINK_MODULAR : 0) |
+		      (option_mark_input ? LINK_MARK_INPUT : 0) |
+		      (option_normalize ? LINK_NORMALIZE : 0) |
+		      (option_verbose ? LINK_LENIENT : 0), size2+1);
+  if(!linker) {
+    fprintf(stderr, "%s: cannot allocate a linker\n", program_name);
+    exit(-1);
+  }
+
   /* Read in logic programs or modules one by one as program1;
      the result of the concatenation accumulates as program2 */
 
+  if(option_multiplex)
+    mux = open_streams(fcnt, files, option_multiplex);
+
   while(i<fcnt) {
 
-    if(!option_recursive || in == NULL) {
+    if(mux) {
+      /* Take the next complete module from any of the files */
+
+      if((in = next_module(mux)) == NULL)
+	break;
+
+    } else if(!option_recursive || in == NULL) {
 
       if(ismeta[i]) {
 	if(!meta) {
@@ -254,99 +436,49 @@ int main(int argc, char **argv)
 	exit(-1);
       }
     }
-    program1 = read_program(in);
-    table1 = read_symbols(in);
-    number1 = read_compute_statement(in, table1);
-
-    /* Close the input file for not to have too many open files */
-
-    if(!option_recursive && in != stdin) {
-      fclose(in); in = NULL;
-    }
-
-   if(option_mark_input)
-      /* Atoms having no defining atoms are marked as input atoms */
-     mark_io_atoms(program1, table1, ++module);
-
-    /* Calculate cross-references from table1 to table2 */
-
-    initialize_other_tables(table1, table2);
-    doubly_defined = combine_atom_tables(table1, table2, 0, 0, option_modular);
-
-    if(doubly_defined) {
-      if(!option_verbose) {
-	out = stderr;
-	fprintf(out, "%s: module error: ", program_name);
-      } else {
-	fprintf(out, "%s: warning: ", program_name);
-      }
-      write_atom(STYLE_READABLE, out, doubly_defined, table1);
-      fprintf(out, " is defined by several modules!\n");
-      /* The given programs do not form proper modules */
-      if(!option_verbose)
+    if(is_aspif(in)) {
+      program1 = read_aspif(in, &table1, aspif_message);
+      if(!table1) {
+	fprintf(stderr, "%s: aspif: %s\n", program_name, aspif_message);
 	exit(-1);
+      }
+      number1 = 1;
+      if(!started && !option_verbose)
+	option_aspif = -1;
+    } else {
+      program1 = read_program(in);
+      table1 = read_symbols(in);
+      number1 = read_compute_statement(in, table1);
     }
 
-    /* Relocate/compress the symbol table and relocate rules */
-
-    if(table1 && table1->next)
-      table1 = make_contiguous(table1);  /* Assumed by relocation procedures */
-
-    mark_visible(table1);
-    mark_occurrences(program1, table1);
-
-    size1 = reloc_symbol_table(table1, size2) - size2;
-
-    if(option_collect)
-      reloc_program(program1, table1);
-    else {
-      /* Write rules immediately and free the memory */
-
-      if(option_verbose)
-	spit_program(STYLE_READABLE, out, program1, table1);
-      else
-	spit_program(STYLE_SMODELS, out, program1, table1);
-
-      free_program(program1);
-      program1 = NULL;
+    if(!started) {
+      started = -1;
+      if(option_aspif)
+	write_aspif_header(out);
+      set_linker_output(linker, out,
+			option_verbose ? STYLE_READABLE :
+			option_aspif ? STYLE_ASPIF : STYLE_SMODELS);
     }
 
-    transfer_status_bits(table1, table2); /* MARK_TRUE/FALSE/HEADOCC */
-
-    if(size1>0) {
-      /* Append table1 after table2 */
-
-      table1 = compress_symbol_table(table1, size1, size2);
-      attach_atoms_to_names(table1);
-      table2 = append_table(table2, table1);
-      table1 = NULL;
-
-      size2 += size1;
-
-    } else {
-      /* Get disposed of table1 */
-
-      free(table1->names);
-      free(table1->statuses);
-      free(table1->others);
-      free(table1);
+    /* Close the input file for not to have too many open files */
 
-      table1 = NULL;
+    if(!option_recursive && in != stdin) {
+      fclose(in); in = NULL;
     }
 
-    size1 = 0;
-
-    if(option_collect) {
-      program2 = append_rules(program2, program1);
-      program1 = NULL;
+    if(link_program(linker, program1, table1, number1) != LINK_OK) {
+      fprintf(stderr, "%s: %s\n", program_name, linker_error(linker));
+      exit(-1);
     }
-
-    number2 *= number1;
-    number1 = 0;
+    program1 = NULL;
+    table1 = NULL;
 
     /* Proceed to the next program/module */
 
-    if(option_recursive) {
+    if(mux) {
+      fclose(in);
+      in = NULL;
+    } else if(option_recursive) {
       if(feof(in)) {
 	fclose(in);
 	in = NULL;
@@ -357,17 +489,49 @@ int main(int argc, char **argv)
       i++;
   }
 
+  if(mux)
+    close_streams(mux);
+
   /* Check module conditions */
 
-  if(option_modular && option_collect) {
-    /* Form the dependency graph */
-    occtab2 = initialize_occurrences(table2);
-    compute_occurrences(program2, occtab2, 0);
+  if(check_module_conditions(linker, cachefile) != LINK_OK) {
+    fprintf(stderr, "%s: %s\n", program_name, linker_error(linker));
+    exit(-1);
+  }
+
+  program2 = linked_program(linker);
+  table2 = linked_table(linker);
+
+  if(option_normalize)
+    write_normalization_stats(stderr, linked_normstats(linker));
+
+  /* Slice and simplify the linked program and compact the symbol table */
 
-    /* Calculate strongly connected components and check module conditions */
-    compute_joint_sccs(occtab2, size2);
+  if((option_slice || option_equivalences) && table2 && table2->next)
+    table2 = make_contiguous(table2);
+
+  if(option_slice && table2) {
+    program2 = slice_program(program2, table2, query_cnt, queries,
+			     &slicestats);
+    write_slicing_stats(stderr, &slicestats);
+  }
+
+  if(option_simplify && table2) {
+    program2 = simplify_program(program2, table2, &simpstats);
+    write_simplification_stats(stderr, &simpstats);
   }
 
+  if(option_equivalences && table2) {
+    program2 = collapse_equivalences(program2, table2, &eqstats);
+    write_equivalence_stats(stderr, &eqstats);
+  }
+
+  if((option_slice || option_simplify || option_equivalences) && table2)
+    table2 = compact_program(program2, table2);
+
+  if(option_order > 0 && table2)
+    table2 = renumber_program(program2, table2, option_order);
+
   /* Print the result of concatenation */
 
   if(option_verbose) {
@@ -391,33 +555,34 @@ int main(int argc, char **argv)
     write_symbols(STYLE_READABLE, out, table2);
     fprintf(out, "\n");
 
-  } else { /* !option_verbose */
+  } else if(option_aspif) {
 
     if(option_collect) {
       if(table2 && table2->next)
 	table2 = make_contiguous(table2);
-      write_program(STYLE_SMODELS, out, program2, table2);
+      if(write_aspif_program(out, program2, linked_priority(linker)) < 0) {
+	fprintf(stderr, "%s: aspif: unsupported rule type\n", program_name);
+	exit(-1);
+      }
     }
-    fprintf(out, "0\n");
 
-    write_symbols(STYLE_SMODELS, out, table2);
-    fprintf(out, "0\n");
+    if(!option_mark_input)
+      reset_input_atoms(table2);
+    write_aspif_tables(out, table2);
 
-    fprintf(out, "B+\n");
-    write_compute_statement(STYLE_SMODELS, out, table2, MARK_TRUE);
-    fprintf(out, "0\n");
+    if(option_symbols) {
+      /* Create a dummy program containing only symbol names */
 
-    fprintf(out, "B-\n");
-    write_compute_statement(STYLE_SMODELS, out, table2, MARK_FALSE);
-    fprintf(out, "0\n");
+      write_aspif_header(sym);
+      write_aspif_symbols(sym, table2);
+      fprintf(sym, "0\n");
+    }
 
-    if(!option_mark_input)
-      reset_input_atoms(table2);
-    fprintf(out, "E\n");
-    write_compute_statement(STYLE_SMODELS, out, table2, MARK_INPUT);
-    fprintf(out, "0\n");
+  } else { /* !option_verbose */
 
-    fprintf(out, "%i\n", number2);
+    set_linked_program(linker, program2, table2);
+    write_linked_program(linker, out);
+    table2 = linked_table(linker);
 
     if(option_symbols) {
       /* Create a dummy program containing only symbol names */
@@ -435,450 +600,3 @@ int main(int argc, char **argv)
 
   exit(0);
 }
-
-/* ------------------------- Local output routines ------------------------- */
-
-void spit_atom(int style, FILE *out, int atom, ATAB *table)
-{
-  int offset = table->offset;
-  int count = table->count;
-  int shift = table->shift;
-  int *others = table->others;
-  int atom2 = others[atom-offset];
-
-  if(style == STYLE_SMODELS)
-    fprintf(out, " %i", atom2+shift);
-  else {
-    SYMBOL **symbols = table->names;
-    SYMBOL *sym = symbols[atom-offset];
-
-    if(sym)
-      write_name(out, sym, table->prefix, table->postfix);
-    else
-      fprintf(out, "_%i", atom2+shift);
-  }
-
-  return;
-}
-
-void spit_literal_list(int style, FILE *out, char *separator,
-		       int pos_cnt, int *pos,
-		       int neg_cnt, int *neg,
-		       int *weight, ATAB *table)
-{
-  int *scan = NULL;
-  int *last = NULL;
-  int *wscan = weight;
-  int *wlast = &weight[pos_cnt+neg_cnt];
-
-  for(scan = neg, last = &neg[neg_cnt];
-      scan != last; ) {
-    if(style == STYLE_READABLE)
-      fprintf(out, "not ");
-    spit_atom(style, out, *scan, table);
-    if(wscan && (style == STYLE_READABLE))
-      fprintf(out, "=%i", *(wscan++));
-    scan++;
-    if(style == STYLE_READABLE)
-      if(scan != last || pos_cnt)
-	fprintf(out, "%s", separator);
-  }
-
-  for(scan = pos, last = &pos[pos_cnt];
-      scan != last; ) {
-    spit_atom(style, out, *scan, table);
-    if(wscan && (style == STYLE_READABLE))
-      fprintf(out, "=%i", *(wscan++));
-    scan++;
-    if(style == STYLE_READABLE)
-      if(scan != last)
-	fprintf(out, "%s", separator);
-  }
-
-  if(wscan && (style == STYLE_SMODELS))
-    while(wscan != wlast)
-      fprintf(out, " %i", *(wscan++));
-
-  return;
-}
-
-void spit_basic(int style, FILE *out, RULE *rule, ATAB *table)
-{
-  int *scan = NULL;
-  int *last = NULL;
-  int pos_cnt = 0;
-  int neg_cnt = 0;
-
-  BASIC_RULE *basic = rule->data.basic;
-
-  if(style == STYLE_SMODELS)
-    fprintf(out, "1");
-
-  spit_atom(style, out, basic->head, table);
-
-  pos_cnt = basic->pos_cnt;
-  neg_cnt = basic->neg_cnt;
-
-  if(style == STYLE_SMODELS)
-    fprintf(out, " %i %i", (pos_cnt+neg_cnt), neg_cnt);
-
-  if(pos_cnt || neg_cnt) {
-    if(style == STYLE_READABLE)
-      fprintf(out, " :- ");
-
-    spit_literal_list(style, out, ", ",
-		       pos_cnt, basic->pos,
-		       neg_cnt, basic->neg,
-		       NULL, table);
-  }
-
-  if(style == STYLE_READABLE)
-    fprintf(out, ".");
-  fprintf(out, "\n");
-
-  return;
-}
-
-void spit_constraint(int style, FILE *out, RULE *rule, ATAB *table)
-{
-  int pos_cnt = 0;
-  int neg_cnt = 0;
-  int bound = 0;
-
-  CONSTRAINT_RULE *constraint = rule->data.constraint;
-
-  if(style == STYLE_SMODELS)
-    fprintf(out, "2");
-
-  spit_atom(style, out, constraint->head, table);
-
-  pos_cnt = constraint->pos_cnt;
-  neg_cnt = constraint->neg_cnt;
-  bound = constraint->bound;
-
-  if(style == STYLE_SMODELS)
-    fprintf(out, " %i %i %i", (pos_cnt+neg_cnt), neg_cnt, bound);
-
-  if(style == STYLE_READABLE)
-    fprintf(out, " :- %i {", bound);
-
-  if(pos_cnt || neg_cnt)
-    spit_literal_list(style, out, ", ",
-		       pos_cnt, constraint->pos,
-		       neg_cnt, constraint->neg,
-		       NULL, table);
-
-  if(style == STYLE_READABLE)
-    fprintf(out, "}.");
-
-  fprintf(out, "\n");
-
-  return;
-}
-
-void spit_choice(int style, FILE *out, RULE *rule, ATAB *table)
-{
-  int head_cnt = 0;
-  int pos_cnt = 0;
-  int neg_cnt = 0;
-  char *separator = ", ";
-
-  CHOICE_RULE *choice = rule->data.choice;
-  head_cnt = choice->head_cnt;
-  pos_cnt = choice->pos_cnt;
-  neg_cnt = choice->neg_cnt;
-
-  if(style == STYLE_SMODELS)
-    fprintf(out, "3 %i", head_cnt);
-  else if(style == STYLE_READABLE)
-    fprintf(out, "{");
-
-  spit_literal_list(style, out, separator,
-		     head_cnt, choice->head,
-		     0, NULL,
-		     NULL, table);
-
-  if(style == STYLE_READABLE)
-    fprintf(out, "}");
-
-  if(style == STYLE_SMODELS)
-    fprintf(out, " %i %i", (pos_cnt+neg_cnt), neg_cnt);
-
-  if(pos_cnt || neg_cnt) {
-    if(style == STYLE_READABLE)
-      fprintf(out, " :- ");
-
-    spit_literal_list(style, out, ", ",
-		       pos_cnt, choice->pos,
-		       neg_cnt, choice->neg,
-		       NULL, table);
-  }
-
-  if(style == STYLE_READABLE)
-    fprintf(out, ".");
-  fprintf(out, "\n");
-
-  return;
-}
-
-void spit_integrity(int style, FILE *out, RULE *rule, ATAB *table)
-{
-  int *scan = NULL;
-  int *last = NULL;
-  int pos_cnt = 0;
-  int neg_cnt = 0;
-
-  INTEGRITY_RULE *integrity = rule->data.integrity;
-
-  if(style == STYLE_SMODELS)
-    fprintf(out, "4");
-
-  pos_cnt = integrity->pos_cnt;
-  neg_cnt = integrity->neg_cnt;
-
-  if(style == STYLE_SMODELS)
-    fprintf(out, " %i %i", (pos_cnt+neg_cnt), neg_cnt);
-
-  if(pos_cnt || neg_cnt) {
-    if(style == STYLE_READABLE)
-      fprintf(out, " :- ");
-
-    spit_literal_list(style, out, ", ",
-		       pos_cnt, integrity->pos,
-		       neg_cnt, integrity->neg,
-		       NULL, table);
-  }
-
-  if(style == STYLE_READABLE)
-    fprintf(out, ".");
-  fprintf(out, "\n");
-
-  return;
-}
-
-void spit_weight(int style, FILE *out, RULE *rule, ATAB *table)
-{
-  int pos_cnt = 0;
-  int neg_cnt = 0;
-  int bound = 0;
-
-  WEIGHT_RULE *weight = rule->data.weight;
-
-  if(style == STYLE_SMODELS)
-    fprintf(out, "5");
-
-  spit_atom(style, out, weight->head, table);
-
-  pos_cnt = weight->pos_cnt;
-  neg_cnt = weight->neg_cnt;
-  bound = weight->bound;
-
-  if(style == STYLE_SMODELS)
-    fprintf(out, " %i %i %i", bound, (pos_cnt+neg_cnt), neg_cnt);
-
-  if(style == STYLE_READABLE)
-    fprintf(out, " :- %i [", bound);
-
-  if(pos_cnt || neg_cnt)
-    spit_literal_list(style, out, ", ",
-		       pos_cnt, weight->pos,
-		       neg_cnt, weight->neg,
-		       weight->weight, table);
-
-  if(style == STYLE_READABLE)
-    fprintf(out, "].");
-  fprintf(out, "\n");
-
-  return;
-}
-
-void spit_optimize(int style, FILE *out, RULE *rule, ATAB *table)
-{
-  int pos_cnt = 0;
-  int neg_cnt = 0;
-
-  OPTIMIZE_RULE *optimize = rule->data.optimize;
-
-  if(style == STYLE_SMODELS)
-    fprintf(out, "6 0");
-
-  pos_cnt = optimize->pos_cnt;
-  neg_cnt = optimize->neg_cnt;
-
-  if(style == STYLE_SMODELS)
-    fprintf(out, " %i %i", (pos_cnt+neg_cnt), neg_cnt);
-
-  if(pos_cnt || neg_cnt) {
-    if(style == STYLE_READABLE)
-      fprintf(out, "minimize [");
-
-    spit_literal_list(style, out, ", ",
-		       pos_cnt, optimize->pos,
-		       neg_cnt, optimize->neg,
-		       optimize->weight, table);
-  }
-
-  if(style == STYLE_READABLE)
-    fprintf(out, "].");
-  fprintf(out, "\n");
-
-  return;
-}
-
-void spit_disjunctive(int style, FILE *out, RULE *rule, ATAB *table)
-{
-  int head_cnt = 0;
-  int pos_cnt = 0;
-  int neg_cnt = 0;
-  char *separator = ", ";
-
-  DISJUNCTIVE_RULE *disjunctive = rule->data.disjunctive;
-  head_cnt = disjunctive->head_cnt;
-  pos_cnt = disjunctive->pos_cnt;
-  neg_cnt = disjunctive->neg_cnt;
-
-  if(style == STYLE_SMODELS)
-    fprintf(out, "8 %i", head_cnt);
-  else if(style == STYLE_READABLE)
-    fprintf(out, "{");
-
-  spit_literal_list(style, out, separator,
-		     head_cnt, disjunctive->head,
-		     0, NULL,
-		     NULL, table);
-
-  if(style == STYLE_READABLE)
-    fprintf(out, "}");
-
-  if(style == STYLE_SMODELS)
-    fprintf(out, " %i %i", (pos_cnt+neg_cnt), neg_cnt);
-
-  if(pos_cnt || neg_cnt) {
-    if(style == STYLE_READABLE)
-      fprintf(out, " :- ");
-
-    spit_literal_list(style, out, ", ",
-		       pos_cnt, disjunctive->pos,
-		       neg_cnt, disjunctive->neg,
-		       NULL, table);
-  }
-
-  if(style == STYLE_READABLE)
-    fprintf(out, ".");
-  fprintf(out, "\n");
-
-  return;
-}
-
-void spit_rule(int style, FILE *out, RULE *rule, ATAB *table)
-{
-  switch(rule->type) {
-  case TYPE_BASIC:
-    spit_basic(style, out, rule, table);
-    break;
-
-  case TYPE_CONSTRAINT:
-    spit_constraint(style, out, rule, table);
-    break;
-
-  case TYPE_CHOICE:
-    spit_choice(style, out, rule, table);
-    break;
-
-  case TYPE_INTEGRITY:
-    spit_integrity(style, out, rule, table);
-    break;
-
-  case TYPE_WEIGHT:
-    spit_weight(style, out, rule, table);
-    break;
-
-  case TYPE_OPTIMIZE:
-    spit_optimize(style, out, rule, table);
-    break;
-
-  case TYPE_DISJUNCTIVE:
-    spit_disjunctive(style, out, rule, table);
-    break;
-
-  default:
-    error("unknown rule type");
-  }
-}
-
-void spit_program(int style, FILE *out, RULE *rule, ATAB *table)
-{
-  if(style != STYLE_READABLE && style != STYLE_SMODELS) {
-    fprintf(stderr, "%s: unknown style %i for spit_rule\n",
-	    program_name, style);
-    exit(-1);
-  }
-
-  if(!table || table->next) {
-    fprintf(stderr,
-	    "spit_rule: the first symbol table should be contiguous!\n");
-    exit(-1);
-  }
-
-  while(rule) {
-    spit_rule(style, out, rule, table);
-    rule = rule->next;
-  }
-  return;
-}
-
-void transfer_status_bits(ATAB *table1, ATAB *table2)
-{
-  ATAB *scan = table1;
-  int i = 0;
-
-  /* Presumes a previous call to attach_atoms_to_names(table2) */
-
-  while(scan) {
-    int count = scan->count;
-    int offset = scan->offset;
-    SYMBOL **names = scan->names;
-
-    for(i=1; i<=count; i++) {
-      int atom = i+offset;
-      SYMBOL *sym = names[i];
-
-      if(sym) {   /* The atom has a symbolic name */
-
-	ATAB *other = sym->info.table;    /* Relevant piece */
-	int atom2 = sym->info.atom;
-	
-	if(atom2 && other) {
-	  int j = atom2 - other->offset;  /* Calculate index */
-
-	  (other->statuses)[j] |=
-	    ((scan->statuses)[i] & (MARK_TRUE_OR_FALSE|MARK_HEADOCC));
-
-	}
-      }
-    }
-    scan = scan->next;
-  }
-
-  return;
-}
-
-void reset_input_atoms(ATAB *table)
-{
-  while(table) {
-    int count = table->count;
-    SYMBOL **names = table->names;
-    int *statuses = table->statuses;
-    int i = 0;
-
-    for(i = 1; i <= count; i++)
-
-      /* Reset the input status if defining rules exist */
-      if(names[i] && (statuses[i] & MARK_HEADOCC))
-	statuses[i] &= ~MARK_INPUT;
-
-    table = table->next;
-  }
-
-  return;
-}
@@ -0,0 +1,553 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * LPGEN -- Generating synthetic ground programs in SMODELS format
+ *
+ * (c) 2026 Tomi Janhunen
+ *
+ * Each module has the same number of atoms, a given percentage of which
+ * are shared with other modules under the names s(j); the others are
+ * local to module i and named a(i,k). The atoms that a module may define
+ * are shuffled and partitioned into components that are made strongly
+ * connected by a cycle of rules. The remaining rules only depend
+ * positively on atoms in the same or earlier components, so that the
+ * components are exactly the SCCs of the module.
+ *
+ * Under module conditions (-M), each shared atom is defined by exactly
+ * one module and forms a component of its own, and module i depends
+ * positively only on shared atoms defined by modules 1, ..., i-1.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "output.h"
+
+/* ------------------------- Buffered output ------------------------------ */
+
+void put_list(OUTPUT *out, int cnt, int *list)
+{
+  int i = 0;
+
+  for(i=0; i<cnt; i++) {
+    put_string(out, " ");
+    put_int(out, list[i]);
+  }
+
+  return;
+}
+
+/* ------------------------- Random numbers ------------------------------- */
+
+/* A 64-bit xorshift* generator: reproducible across platforms, and each
+   module is generated from a state of its own */
+
+typedef unsigned long long RANDOM;
+
+RANDOM seed_random(long seed, int module)
+{
+  RANDOM state = (RANDOM)seed * 0x9e3779b97f4a7c15ULL
+    ^ ((RANDOM)(module+1) << 32);
+
+  state ^= state >> 31;
+  state *= 0xbf58476d1ce4e5b9ULL;
+  state ^= state >> 29;
+
+  return state ? state : 1;
+}
+
+long uniform(RANDOM *state, long n) /* Uniformly in 0, ..., n-1 */
+{
+  RANDOM x = *state;
+
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+
+  return (long)(((x * 0x2545f4914f6cdd1dULL) >> 11) % (RANDOM)n);
+}
+
+long between(RANDOM *state, int min, int max)
+{
+  return min + uniform(state, max-min+1);
+}
+
+/* ------------------------- Parameters ----------------------------------- */
+
+#define TYPE_CNT 5
+
+typedef struct params {
+  int atoms;            /* Atoms per module */
+  int rules;            /* Rules per module */
+  int modules;
+  int mix[TYPE_CNT];    /* Basic, choice, weight, disjunctive, optimize */
+  int head_min, head_max;
+  int body_min, body_max;
+  int scc_min, scc_max;
+  int shared;           /* Percentage of shared atoms */
+  int modular;          /* Respect module conditions */
+  long seed;
+} PARAMS;
+
+int rule_types[TYPE_CNT] = { 1, 3, 5, 8, 6 };
+
+/* ------------------------- Generating a module -------------------------- */
+
+typedef struct module {
+  int number;           /* 0, ..., modules-1 */
+  int shared;           /* Shared atoms 1, ..., shared */
+  int atoms;            /* All atoms 1, ..., atoms */
+  int defcnt;
+  int *defs;            /* Definable atoms in the order of components */
+  int *start;           /* Start of the component of each position */
+  int *end;             /* End of the component of each position */
+  int *heads;
+  int *pos;
+  int *neg;
+  int *weights;
+  RANDOM state;
+} MODULE;
+
+int owner(PARAMS *params, int atom) /* Module defining a shared atom */
+{
+  return (atom-1) % params->modules;
+}
+
+void form_components(PARAMS *params, MODULE *m)
+{
+  int i = 0, j = 0;
+
+  /* Definable atoms in a random order */
+
+  m->defcnt = 0;
+  for(i=1; i<=m->atoms; i++)
+    if(i > m->shared || !params->modular || owner(params, i) == m->number)
+      m->defs[m->defcnt++] = i;
+
+  for(i=m->defcnt-1; i>0; i--) {
+    int k = uniform(&m->state, i+1);
+    int atom = m->defs[i];
+
+    m->defs[i] = m->defs[k];
+    m->defs[k] = atom;
+  }
+
+  /* Components of local atoms; shared atoms stay singletons */
+
+  i = 0;
+  while(i < m->defcnt) {
+    int size = between(&m->state, params->scc_min, params->scc_max);
+    int last = i;
+
+    if(m->defs[i] > m->shared)
+      while(last+1 < m->defcnt && last+1 < i+size
+	    && m->defs[last+1] > m->shared)
+	last++;
+
+    for(j=i; j<=last; j++) {
+      m->start[j] = i;
+      m->end[j] = last+1;
+    }
+
+    i = last+1;
+  }
+
+  return;
+}
+
+/* A shared atom defined by an earlier module (or 0 if none exists) */
+
+int input_atom(PARAMS *params, MODULE *m)
+{
+  int o = 0;
+  int cnt = 0;
+
+  if(!params->modular || m->number == 0)
+    return 0;
+
+  o = uniform(&m->state, m->number);
+  if(o >= m->shared)
+    return 0;
+  cnt = (m->shared - o + params->modules - 1)/params->modules;
+
+  return 1 + o + params->modules*uniform(&m->state, cnt);
+}
+
+int positive_atom(PARAMS *params, MODULE *m, int p)
+{
+  int atom = 0;
+
+  if(uniform(&m->state, 100) < params->shared)
+    atom = input_atom(params, m);
+
+  if(!atom) {
+    if(uniform(&m->state, 2))
+      atom = m->defs[between(&m->state, m->start[p], m->end[p]-1)];
+    else
+      atom = m->defs[uniform(&m->state, m->end[p])];
+  }
+
+  return atom;
+}
+
+void write_cycles(OUTPUT *out, MODULE *m, int *rule_cnt)
+{
+  int i = 0;
+
+  for(i=0; i<m->defcnt; i++) {
+    int next = i+1 < m->end[i] ? i+1 : m->start[i];
+
+    if(m->end[i] - m->start[i] < 2)
+      continue;
+
+    /* a :- b, not c. where b follows a on the cycle */
+
+    put_string(out, "1 ");
+    put_int(out, m->defs[i]);
+    put_string(out, " 2 1 ");
+    put_int(out, 1 + uniform(&m->state, m->atoms));
+    put_string(out, " ");
+    put_int(out, m->defs[next]);
+    put_string(out, "\n");
+
+    (*rule_cnt)++;
+  }
+
+  return;
+}
+
+void write_random_rule(OUTPUT *out, PARAMS *params, MODULE *m)
+{
+  int total = 0;
+  int type = 0;
+  int p = uniform(&m->state, m->defcnt);
+  int head_cnt = 1;
+  int pos_cnt = 0, neg_cnt = 0;
+  int len = 0;
+  int i = 0, j = 0;
+
+  for(i=0; i<TYPE_CNT; i++)
+    total += params->mix[i];
+
+  j = uniform(&m->state, total);
+  for(i=0; j >= params->mix[i]; i++)
+    j -= params->mix[i];
+  type = rule_types[i];
+
+  /* Head atoms: the first from a random component and the others from
+     the same or later components */
+
+  m->heads[0] = m->defs[p];
+
+  if(type == 3 || type == 8) {
+    int width = between(&m->state, params->head_min, params->head_max);
+
+    if(width > m->defcnt - m->start[p])
+      width = m->defcnt - m->start[p];
+
+    while(head_cnt < width) {
+      int atom = m->defs[between(&m->state, m->start[p], m->defcnt-1)];
+
+      for(i=0; i<head_cnt && m->heads[i] != atom; i++)
+	;
+      if(i == head_cnt)
+	m->heads[head_cnt++] = atom;
+    }
+  }
+
+  /* Body literals */
+
+  len = between(&m->state, params->body_min, params->body_max);
+  if(len == 0 && (type == 5 || type == 6))
+    len = 1;
+
+  for(i=0; i<len; i++)
+    if(uniform(&m->state, 3) == 0)
+      m->neg[neg_cnt++] = 1 + uniform(&m->state, m->atoms);
+    else
+      m->pos[pos_cnt++] = positive_atom(params, m, p);
+
+  for(i=0; i<len; i++)
+    m->weights[i] = between(&m->state, 1, 5);
+
+  put_int(out, type);
+
+  switch(type) {
+  case 1:
+    put_string(out, " ");
+    put_int(out, m->heads[0]);
+    break;
+  case 3:
+  case 8:
+    put_string(out, " ");
+    put_int(out, head_cnt);
+    put_list(out, head_cnt, m->heads);
+    break;
+  case 5:
+    total = 0;
+    for(i=0; i<len; i++)
+      total += m->weights[i];
+    put_string(out, " ");
+    put_int(out, m->heads[0]);
+    put_string(out, " ");
+    put_int(out, between(&m->state, 1, total));
+    break;
+  case 6:
+    put_string(out, " 0");
+    break;
+  }
+
+  put_string(out, " ");
+  put_int(out, len);
+  put_string(out, " ");
+  put_int(out, neg_cnt);
+  put_list(out, neg_cnt, m->neg);
+  put_list(out, pos_cnt, m->pos);
+  if(type == 5 || type == 6)
+    put_list(out, len, m->weights);
+  put_string(out, "\n");
+
+  return;
+}
+
+void write_module(OUTPUT *out, PARAMS *params, int number)
+{
+  MODULE module;
+  MODULE *m = &module;
+  int size = params->head_max > params->body_max
+    ? params->head_max : params->body_max;
+  int rule_cnt = 0;
+  int i = 0;
+
+  m->number = number;
+  m->atoms = params->atoms;
+  m->shared = (int)((long)params->atoms * params->shared / 100);
+  m->defs = (int *)malloc(m->atoms*sizeof(int));
+  m->start = (int *)malloc(m->atoms*sizeof(int));
+  m->end = (int *)malloc(m->atoms*sizeof(int));
+  m->heads = (int *)malloc((size+1)*sizeof(int));
+  m->pos = (int *)malloc((size+1)*sizeof(int));
+  m->neg = (int *)malloc((size+1)*sizeof(int));
+  m->weights = (int *)malloc((size+1)*sizeof(int));
+  m->state = seed_random(params->seed, number);
+
+  if(!m->defs || !m->start || !m->end) {
+    fprintf(stderr, "lpgen: cannot allocate memory for %i atoms!\n",
+	    m->atoms);
+    exit(-1);
+  }
+
+  form_components(params, m);
+
+  if(m->defcnt) {
+    write_cycles(out, m, &rule_cnt);
+    for(; rule_cnt < params->rules; rule_cnt++)
+      write_random_rule(out, params, m);
+  }
+
+  put_string(out, "0\n");
+
+  for(i=1; i<=m->atoms; i++) {
+    put_int(out, i);
+    if(i <= m->shared) {
+      put_string(out, " s(");
+      put_int(out, i);
+    } else {
+      put_string(out, " a(");
+      put_int(out, number+1);
+      put_string(out, ",");
+      put_int(out, i - m->shared);
+    }
+    put_string(out, ")\n");
+  }
+
+  put_string(out, "0\nB+\n0\nB-\n0\n1\n");
+
+  free(m->defs);
+  free(m->start);
+  free(m->end);
+  free(m->heads);
+  free(m->pos);
+  free(m->neg);
+  free(m->weights);
+
+  return;
+}
+
+/* ------------------------- Main program --------------------------------- */
+
+void usage(char *name)
+{
+  fprintf(stderr, "\nusage:");
+  fprintf(stderr, "   %s <options>\n\n", name);
+  fprintf(stderr, "options:\n");
+  fprintf(stderr, "   -h or --help -- print help message\n");
+  fprintf(stderr, "   -n=<number> -- atoms per module (default 1000)\n");
+  fprintf(stderr, "   -r=<number> -- rules per module (default 2000)\n");
+  fprintf(stderr, "   -m=<number> -- number of modules (default 1)\n");
+  fprintf(stderr, "   -t=<b>,<c>,<w>,<d>,<o>\n");
+  fprintf(stderr, "      -- relative frequencies of basic, choice, weight,\n");
+  fprintf(stderr, "         disjunctive, and optimize rules\n");
+  fprintf(stderr, "         (default 60,15,10,10,5)\n");
+  fprintf(stderr, "   -w=<min>-<max>\n");
+  fprintf(stderr, "      -- head widths of choice and disjunctive rules\n");
+  fprintf(stderr, "         (default 1-3)\n");
+  fprintf(stderr, "   -b=<min>-<max> -- body lengths (default 0-4)\n");
+  fprintf(stderr, "   -c=<min>-<max> -- sizes of SCCs (default 1-5)\n");
+  fprintf(stderr, "   -s=<percent>\n");
+  fprintf(stderr, "      -- atoms shared across modules (default 10)\n");
+  fprintf(stderr, "   -M -- respect module conditions (see lpcat -m)\n");
+  fprintf(stderr, "   -x=<number> -- random seed (default 1)\n");
+  fprintf(stderr, "   -o=<prefix>\n");
+  fprintf(stderr, "      -- write module i to <prefix>-<i>.sm rather than\n");
+  fprintf(stderr, "         all modules to the standard output\n");
+  fprintf(stderr, "\n");
+
+  return;
+}
+
+void parse_range(char *name, char *arg, int min, int *first, int *last)
+{
+  char *end = NULL;
+
+  *first = *last = (int)strtol(arg, &end, 10);
+
+  if(*end == '-')
+    *last = (int)strtol(end+1, &end, 10);
+
+  if(*end || *first < min || *last < *first) {
+    fprintf(stderr, "%s: invalid range %s\n", name, arg);
+    exit(-1);
+  }
+
+  return;
+}
+
+int parse_number(char *name, char *arg, int min)
+{
+  char *end = NULL;
+  long value = strtol(arg, &end, 10);
+
+  if(*end || end == arg || value < min) {
+    fprintf(stderr, "%s: invalid number %s\n", name, arg);
+    exit(-1);
+  }
+
+  return (int)value;
+}
+
+OUTPUT output;
+
+int main(int argc, char **argv)
+{
+  PARAMS params = { 1000, 2000, 1, { 60, 15, 10, 10, 5 },
+		    1, 3, 0, 4, 1, 5, 10, 0, 1 };
+  char *prefix = NULL;
+  OUTPUT *out = &output;
+  int total = 0;
+  int i = 0;
+
+  for(i=1; i<argc; i++) {
+    char *arg = argv[i];
+
+    if(strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+      usage(argv[0]);
+      exit(0);
+    } else if(strcmp(arg, "-M") == 0)
+      params.modular = -1;
+    else if(strncmp(arg, "-n=", 3) == 0)
+      params.atoms = parse_number(argv[0], &arg[3], 1);
+    else if(strncmp(arg, "-r=", 3) == 0)
+      params.rules = parse_number(argv[0], &arg[3], 0);
+    else if(strncmp(arg, "-m=", 3) == 0)
+      params.modules = parse_number(argv[0], &arg[3], 1);
+    else if(strncmp(arg, "-t=", 3) == 0) {
+      char *p = &arg[3];
+      int j = 0;
+
+      for(j=0; j<TYPE_CNT; j++) {
+	char *end = NULL;
+
+	params.mix[j] = (int)strtol(p, &end, 10);
+	if(end == p || params.mix[j] < 0 || (*end && *end != ',')
+	   || (j < TYPE_CNT-1 && !*end)) {
+	  fprintf(stderr, "%s: invalid rule type mix %s\n", argv[0], &arg[3]);
+	  exit(-1);
+	}
+	p = *end ? end+1 : end;
+      }
+    } else if(strncmp(arg, "-w=", 3) == 0)
+      parse_range(argv[0], &arg[3], 1, &params.head_min, &params.head_max);
+    else if(strncmp(arg, "-b=", 3) == 0)
+      parse_range(argv[0], &arg[3], 0, &params.body_min, &params.body_max);
+    else if(strncmp(arg, "-c=", 3) == 0)
+      parse_range(argv[0], &arg[3], 1, &params.scc_min, &params.scc_max);
+    else if(strncmp(arg, "-s=", 3) == 0) {
+      params.shared = parse_number(argv[0], &arg[3], 0);
+      if(params.shared > 100) {
+	fprintf(stderr, "%s: invalid percentage %s\n", argv[0], &arg[3]);
+	exit(-1);
+      }
+    } else if(strncmp(arg, "-x=", 3) == 0)
+      params.seed = strtol(&arg[3], NULL, 10);
+    else if(strncmp(arg, "-o=", 3) == 0)
+      prefix = &arg[3];
+    else {
+      fprintf(stderr, "%s: unknown option %s\n", argv[0], arg);
+      usage(argv[0]);
+      exit(-1);
+    }
+  }
+
+  for(i=0; i<TYPE_CNT; i++)
+    total += params.mix[i];
+
+  if(total == 0) {
+    fprintf(stderr, "%s: no rule types to generate!\n", argv[0]);
+    exit(-1);
+  }
+
+  set_output(out, stdout, argv[0]);
+
+  for(i=0; i<params.modules; i++) {
+    char *file = NULL;
+
+    if(prefix) {
+      file = (char *)malloc(strlen(prefix)+32);
+      sprintf(file, "%s-%i.sm", prefix, i+1);
+      if((out->file = fopen(file, "w")) == NULL) {
+	fprintf(stderr, "%s: cannot create file %s\n", argv[0], file);
+	exit(-1);
+      }
+    }
+
+    write_module(out, &params, i);
+    flush_output(out);
+
+    if(prefix) {
+      fclose(out->file);
+      free(file);
+    }
+  }
+
+  exit(0);
+}
@@ -29,6 +29,11 @@
 #include <time.h>
 #include <unistd.h>
 #include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 
 #include "version.h"
 #include "symbol.h"
@@ -36,6 +41,12 @@
 #include "rule.h"
 #include "io.h"
 #include "scc.h"
+#include "normalize.h"
+#include "simplify.h"
+#include "share.h"
+#include "cache.h"
+#include "aspif.h"
+#include "linker.h"
 
 void _version_lpshift_c()
 {
@@ -47,40 +58,97 @@ void _version_lpshift_c()
   _version_rule_c();
   _version_input_c();
   _version_output_c();
+  _version_normalize_c();
+  _version_simplify_c();
+  _version_share_c();
+  _version_cache_c();
+  _version_aspif_c();
+  _version_linker_c();
 }
 
 void usage()
 {
   fprintf(stderr, "\nusage:");
-  fprintf(stderr, "   lpshift <options> <file>\n\n");
+  fprintf(stderr, "   lpshift <options> <file>\n");
+  fprintf(stderr, "   lpshift <options> --link <file> ...\n\n");
   fprintf(stderr, "options:\n");
   fprintf(stderr, "   -h or --help -- print help message\n");
   fprintf(stderr, "   --version    -- print version information\n");
-  fprintf(stderr, "   -f           -- forced shift (SCCs neglected)\n");
+  fprintf(stderr, "   -f           -- forced shift (SCCs neglected, rules streamed)\n");
   fprintf(stderr, "   --bc         -- force body compression\n");
   fprintf(stderr, "   --nb         -- no body compression\n");
+  fprintf(stderr, "   --gb         -- share compressed bodies globally\n");
+  fprintf(stderr, "   --lin        -- linear-size shifting of wide heads\n");
+  fprintf(stderr, "   -n           -- normalize rules before shifting\n");
+  fprintf(stderr, "   --wf         -- simplify using the well-founded model\n");
   fprintf(stderr, "   -v           -- verbose (human readable) output\n");
+  fprintf(stderr, "   --aspif      -- aspif output (default for aspif input)\n");
+  fprintf(stderr, "   --threads N  -- shift rules using N threads\n");
+  fprintf(stderr, "   --batch      -- <file> lists pairs of input and output files\n");
+  fprintf(stderr, "   --workers N  -- process a batch using N worker processes\n");
+  fprintf(stderr, "   --cache F    -- keep SCCs in the sidecar file F for reuse\n");
+  fprintf(stderr, "   --link       -- link the files as modules first, in process\n");
+  fprintf(stderr, "                   (same output as lpcat -c <file> ... | lpshift)\n");
+  fprintf(stderr, "   -m           -- check module conditions when linking (lpcat -m)\n");
   fprintf(stderr, "\n");
 
   return;
 }
 
 int shift_rule(int style, FILE *out, RULE *rule,
-	       int no_bc, int force_bc, int force,
+	       int no_bc, int force_bc, int force, int linear, BODYTAB *bodies,
 	       ATAB *table, OCCTAB *occtab, int newatom, int verbose);
 
 void transform_into_basic(int style, FILE *out, RULE *rule, ATAB *table);
 
+int count_new_atoms(RULE *program, RULE *end,
+		    int no_bc, int force_bc, int force, int linear,
+		    BODYTAB *bodies, OCCTAB *occtab);
+
+int shift_rules(int style, FILE *out, RULE *program, RULE *end,
+		int no_bc, int force_bc, int force, int linear, BODYTAB *bodies,
+		ATAB *table, OCCTAB *occtab, int newatom, int verbose);
+
+int shift_in_parallel(int threads, int style, FILE *out, RULE *program,
+		      int no_bc, int force_bc, int force, int linear,
+		      BODYTAB *bodies, ATAB *table, OCCTAB *occtab,
+		      int newatom, int verbose);
+
+void write_tables(FILE *out, ATAB *table);
+
+int shifted_heads(RULE *program, int **heads);
+
+BODYTAB *share_bodies(RULE *program, int force_bc, int force, OCCTAB *occtab,
+		      int newatom, SHARESTATS *stats);
+
+void stream_shift(FILE *in, FILE *out, int no_bc, int force_bc, int linear);
+
+void shift_program(FILE *in, FILE *out,
+		   int force, int verbose, int no_bc, int force_bc,
+		   int normalize, int simplify, int threads, int linear, int share,
+		   char *cache, int aspif);
+
+void shift_rules_of(RULE *program, ATAB *table, FILE *out,
+		    int force, int verbose, int no_bc, int force_bc,
+		    int normalize, int simplify, int threads, int linear,
+		    int share, char *cache, int aspif);
+
+void link_and_shift(int fcnt, char **files, int modular, FILE *out,
+		    int force, int verbose, int no_bc, int force_bc,
+		    int normalize, int simplify, int threads, int linear,
+		    int share, char *cache, int aspif);
+
+void batch_shift(FILE *list, int workers,
+		 int force, int verbose, int no_bc, int force_bc,
+		 int normalize, int simplify, int threads, int linear, int share,
+		 int aspif);
+
 int main(int argc, char **argv)
 {
+  char **files = (char **)malloc(argc*sizeof(char *));
+  int fcnt = 0;
   char *file = NULL;
   FILE *in = NULL;
-  RULE *program = NULL;
-  RULE *rule = NULL;
-  ATAB *table = NULL;
-  OCCTAB *occtab = NULL;
-  int newatom = 0;
-  int size = 0;
 
   FILE *out = stdout;
 
@@ -93,6 +161,17 @@ int main(int argc, char **argv)
   int option_verbose = 0;
   int option_force_bodyc = 0;
   int option_no_bodyc = 0;
+  int option_normalize = 0;
+  int option_simplify = 0;
+  int option_threads = 1;
+  int option_linear = 0;
+  int option_share = 0;
+  int option_batch = 0;
+  int option_workers = 1;
+  char *option_cache = NULL;
+  int option_aspif = 0;
+  int option_link = 0;
+  int option_modular = 0;
 
   program_name = argv[0];
 
@@ -109,10 +188,44 @@ int main(int argc, char **argv)
       option_force_bodyc = 1;
     else if(strcmp(arg, "--nb") == 0)
       option_no_bodyc = 1;
+    else if(strcmp(arg, "--gb") == 0)
+      option_share = 1;
+    else if(strcmp(arg, "--lin") == 0)
+      option_linear = 1;
     else if(strcmp(arg, "-v") == 0)
       option_verbose = 1;
-    else if(file == NULL)
-      file = arg;
+    else if(strcmp(arg, "--aspif") == 0)
+      option_aspif = 1;
+    else if(strcmp(arg, "-n") == 0)
+      option_normalize = 1;
+    else if(strcmp(arg, "--wf") == 0)
+      option_simplify = 1;
+    else if(strcmp(arg, "--threads") == 0 && which+1 < argc) {
+      option_threads = atoi(argv[++which]);
+      if(option_threads < 1) {
+	fprintf(stderr, "%s: invalid number of threads %s\n",
+		program_name, argv[which]);
+	exit(-1);
+      }
+    }
+    else if(strcmp(arg, "--batch") == 0)
+      option_batch = 1;
+    else if(strcmp(arg, "--workers") == 0 && which+1 < argc) {
+      option_workers = atoi(argv[++which]);
+      if(option_workers < 1) {
+	fprintf(stderr, "%s: invalid number of workers %s\n",
+		program_name, argv[which]);
+	exit(-1);
+      }
+    }
+    else if(strcmp(arg, "--cache") == 0 && which+1 < argc)
+      option_cache = argv[++which];
+    else if(strcmp(arg, "--link") == 0)
+      option_link = 1;
+    else if(strcmp(arg, "-m") == 0)
+      option_modular = 1;
+    else if(strncmp(arg, "-", 1) != 0 || strlen(arg) == 1)
+      files[fcnt++] = arg;
     else {
       fprintf(stderr, "%s: unknown argument %s\n", program_name, arg);
       usage();
@@ -132,6 +245,56 @@ int main(int argc, char **argv)
     exit(-1);
   }
 
+  if(option_no_bodyc && option_share) {
+    fprintf(stderr, "%s: options --gb and --nb are incompatible!\n",
+	    program_name);
+    exit(-1);
+  }
+
+  if(option_verbose && option_aspif) {
+    fprintf(stderr, "%s: options -v and --aspif are incompatible!\n",
+	    program_name);
+    exit(-1);
+  }
+
+  if(option_batch && option_cache) {
+    fprintf(stderr, "%s: options --batch and --cache are incompatible!\n",
+	    program_name);
+    exit(-1);
+  }
+
+  if(option_link && option_batch) {
+    fprintf(stderr, "%s: options --link and --batch are incompatible!\n",
+	    program_name);
+    exit(-1);
+  }
+
+  if(option_modular && !option_link) {
+    fprintf(stderr, "%s: option -m presumes option --link!\n", program_name);
+    exit(-1);
+  }
+
+  if(fcnt > 1 && !option_link) {
+    fprintf(stderr, "%s: unknown argument %s\n", program_name, files[1]);
+    usage();
+    exit(-1);
+  }
+
+  if(option_link) {
+    if(fcnt == 0)
+      files[fcnt++] = "-";
+
+    link_and_shift(fcnt, files, option_modular, out,
+		   option_force, option_verbose, option_no_bodyc,
+		   option_force_bodyc, option_normalize, option_simplify,
+		   option_threads, option_linear, option_share, option_cache,
+		   option_aspif);
+    exit(0);
+  }
+
+  if(fcnt)
+    file = files[0];
+
   if(file == NULL || strcmp("-", file) == 0) {
     in = stdin;
   } else {
@@ -140,44 +303,169 @@ int main(int argc, char **argv)
       exit(-1);
     }
   }
-  
-  program = read_program(in);
-  table = read_symbols(in);
-  read_compute_statement(in, table);
+
+  if(option_batch)
+    batch_shift(in, option_workers,
+		option_force, option_verbose, option_no_bodyc, option_force_bodyc,
+		option_normalize, option_simplify, option_threads, option_linear,
+		option_share, option_aspif);
+  else
+    shift_program(in, out,
+		  option_force, option_verbose, option_no_bodyc, option_force_bodyc,
+		  option_normalize, option_simplify, option_threads, option_linear,
+		  option_share, option_cache, option_aspif);
+
+  exit(0);
+}
+
+/*
+ * shift_program -- Read a program from in and write it shifted to out
+ */
+
+void shift_program(FILE *in, FILE *out,
+		   int force, int verbose, int no_bc, int force_bc,
+		   int normalize, int simplify, int threads, int linear, int share,
+		   char *cache, int aspif)
+{
+  RULE *program = NULL;
+  ATAB *table = NULL;
+  int aspif_in = 0;
+  char aspif_message[ASPIF_ERROR_SIZE];
+
+  /* The output follows the format of the input by default */
+
+  if(is_aspif(in)) {
+    aspif_in = 1;
+    if(!verbose)
+      aspif = 1;
+  }
+
+  /* Forced shifting is local to rules which can be streamed one by one */
+
+  if(force && !verbose && !normalize && !simplify && threads == 1 && !share
+     && !aspif) {
+    stream_shift(in, out, no_bc, force_bc, linear);
+    return;
+  }
+
+  if(aspif_in) {
+    program = read_aspif(in, &table, aspif_message);
+    if(!table) {
+      fprintf(stderr, "%s: aspif: %s\n", program_name, aspif_message);
+      exit(-1);
+    }
+  } else {
+    program = read_program(in);
+    table = read_symbols(in);
+    read_compute_statement(in, table);
+  }
+
+  shift_rules_of(program, table, out, force, verbose, no_bc, force_bc,
+		 normalize, simplify, threads, linear, share, cache, aspif);
+
+  return;
+}
+
+/*
+ * shift_rules_of -- Shift a program already in memory and write it to out
+ */
+
+void shift_rules_of(RULE *program, ATAB *table, FILE *out,
+		    int force, int verbose, int no_bc, int force_bc,
+		    int normalize, int simplify, int threads, int linear,
+		    int share, char *cache, int aspif)
+{
+  OCCTAB *occtab = NULL;
+  BODYTAB *bodies = NULL;
+  int newatom = 0;
+  int size = 0;
+  int aux_cnt = 0;
+  int style = 0;
+
+  NORMSTATS normstats = { 0, 0, 0, 0, 0 };
+  SIMPSTATS simpstats = { 0, 0, 0, 0, 0, 0, 0 };
+  SHARESTATS sharestats = { 0, 0 };
+
+  if(normalize) {
+    program = normalize_program(program, &normstats);
+    write_normalization_stats(stderr, &normstats);
+  }
+
+  if(simplify) {
+    program = simplify_program(program, table, &simpstats);
+    write_simplification_stats(stderr, &simpstats);
+  }
 
   size = table_size(table);
   newatom = size+1;    
 
   /* Calculate the strongly connected components */
 
-  if(!option_force) {
+  if(!force && cache) {
+    unsigned long long hash = hash_program(program, table);
+
+    /* Reuse the analysis of an earlier run or save it for later runs */
+
+    occtab = initialize_occurrences(table);
+    if(!load_analysis(cache, hash, program, occtab, size)) {
+      compute_occurrences(program, occtab, 0);
+      compute_sccs(occtab, size, MARK_POSOCC);
+      save_analysis(cache, hash, program, occtab, size, 0);
+    }
+
+  } else if(!force) {
+    int *heads = NULL;
+    int head_cnt = shifted_heads(program, &heads);
+
+    /* Only SCCs of atoms in shifted heads are needed */
+
     occtab = initialize_occurrences(table);
-    compute_occurrences(program, occtab, 0);
-    compute_sccs(occtab, size, MARK_POSOCC);
+    compute_positive_occurrences(program, occtab);
+    compute_sccs_from(occtab, size, head_cnt, heads, MARK_POSOCC);
+
+    free(heads);
+  }
+
+  /* Give one atom to each body worth sharing in the entire program */
+
+  if(share) {
+    bodies = share_bodies(program, force_bc, force, occtab, newatom,
+			  &sharestats);
+    write_share_stats(stderr, &sharestats);
+    newatom += sharestats.bodies;
   }
 
   /* Shift atoms from the heads of disjunctive rules as far as possible */
 
-  if(option_verbose) {
-    rule = program;
+  if(verbose)
+    style = STYLE_READABLE;
+  else if(aspif) {
+    style = STYLE_ASPIF;
+    write_aspif_header(out);
+  } else
+    style = STYLE_SMODELS;
+
+  if(threads > 1) {
+    if(sharestats.bodies)
+      extend_table(table, sharestats.bodies, size);
+
+    newatom = shift_in_parallel(threads, style, out, program,
+				no_bc, force_bc, force, linear,
+				bodies, table, occtab, newatom, verbose);
+  } else {
+    /* Reserve auxiliary atoms as a single piece of the table */
 
-    while(rule) {
-      if(rule->type == TYPE_DISJUNCTIVE) {
-	int head_cnt = get_head_cnt(rule);
+    aux_cnt = count_new_atoms(program, NULL, no_bc, force_bc, force, linear,
+			      bodies, occtab);
+    if(sharestats.bodies+aux_cnt)
+      extend_table(table, sharestats.bodies+aux_cnt, size);
 
-	if(head_cnt>1)
-	  newatom =
-	    shift_rule(STYLE_READABLE, out, rule,
-		       option_no_bodyc, option_force_bodyc, option_force,
-		       table, occtab, newatom, option_verbose);
-	else
-	  transform_into_basic(STYLE_READABLE, out, rule, table);
-	  
-      } else
-        write_rule(STYLE_READABLE, out, rule, table);
+    newatom = shift_rules(style, out, program, NULL,
+			  no_bc, force_bc, force, linear,
+			  bodies, table, occtab, newatom, verbose);
+  }
 
-      rule = rule->next;
-    }
+  if(verbose) {
     fprintf(out, "\n");
     fprintf(out, "compute { ");
     write_compute_statement(STYLE_READABLE, out, table, MARK_TRUE|MARK_FALSE);
@@ -185,44 +473,116 @@ int main(int argc, char **argv)
 
     write_input(STYLE_READABLE, out, table);
 
+  } else if(aspif) {
+    write_aspif_minimize(out, program, 0);
+    write_aspif_tables(out, table);
+
   } else { /* !verbose_mode */
-    rule = program;
-
-    while(rule) {
-      if(rule->type == TYPE_DISJUNCTIVE) {
-	int head_cnt = get_head_cnt(rule);
-	
-	if(head_cnt>1) 
-	  newatom =
-	    shift_rule(STYLE_SMODELS, out, rule,
-		       option_no_bodyc, option_force_bodyc, option_force,
-		       table, occtab, newatom, option_verbose);
-	else
-	  transform_into_basic(STYLE_SMODELS, out, rule, table);
-      } else
-        write_rule(STYLE_SMODELS, out, rule, table);
+    fprintf(out, "0\n");
 
-      rule = rule->next;
+    write_tables(out, table);
+  }
+
+  /* Release the memory needed for the next program (batch mode) */
+
+  if(bodies)
+    free_body_table(bodies);
+  if(occtab)
+    free_occurrences(occtab);
+  free_program(program);
+
+  return;
+}
+
+/*
+ * link_and_shift -- Link modules as "lpcat -c" and shift the result
+ *
+ * The linked program is passed on in memory, and only the shifted
+ * program gets written, as if "lpcat -c <file> ... | lpshift" was run.
+ */
+
+void link_and_shift(int fcnt, char **files, int modular, FILE *out,
+		    int force, int verbose, int no_bc, int force_bc,
+		    int normalize, int simplify, int threads, int linear,
+		    int share, char *cache, int aspif)
+{
+  LINKER *linker = new_linker(LINK_COLLECT | (modular ? LINK_MODULAR : 0), 1);
+  RULE *program = NULL;
+  ATAB *table = NULL;
+  FILE *in = NULL;
+  int i = 0;
+
+  if(!linker) {
+    fprintf(stderr, "%s: cannot allocate a linker\n", program_name);
+    exit(-1);
+  }
+
+  for(i=0; i<fcnt; i++) {
+    if(strcmp("-", files[i]) == 0)
+      in = stdin;
+    else if((in = fopen(files[i], "r")) == NULL) {
+      fprintf(stderr, "%s: cannot open file %s\n", program_name, files[i]);
+      exit(-1);
     }
-    fprintf(out, "0\n");
 
-    write_symbols(STYLE_SMODELS, out, table);
-    fprintf(out, "0\n");
+    /* The output follows the format of the first module by default */
 
-    fprintf(out, "B+\n");
-    write_compute_statement(STYLE_SMODELS, out, table, MARK_TRUE);
-    fprintf(out, "0\n");
+    if(i == 0 && is_aspif(in) && !verbose)
+      aspif = 1;
 
-    fprintf(out, "B-\n");
-    write_compute_statement(STYLE_SMODELS, out, table, MARK_FALSE);
-    fprintf(out, "0\n");
+    if(link_stream(linker, in) != LINK_OK) {
+      fprintf(stderr, "%s: %s\n", program_name, linker_error(linker));
+      exit(-1);
+    }
 
-    write_input(STYLE_SMODELS, out, table);
+    if(in != stdin)
+      fclose(in);
+  }
 
-    fprintf(out, "%i\n", 0);
+  if(check_module_conditions(linker, NULL) != LINK_OK) {
+    fprintf(stderr, "%s: %s\n", program_name, linker_error(linker));
+    exit(-1);
   }
 
-  exit(0);
+  /* Pass the linked program on as lpcat would write it */
+
+  program = linked_program(linker);
+  table = linked_table(linker);
+  if(table && table->next)
+    table = make_contiguous(table);
+  reset_input_atoms(table);
+
+  set_linked_program(linker, NULL, NULL);  /* Kept as lpshift keeps its input */
+  free_linker(linker);
+
+  shift_rules_of(program, table, out, force, verbose, no_bc, force_bc,
+		 normalize, simplify, threads, linear, share, cache, aspif);
+
+  return;
+}
+
+/*
+ * write_tables -- Write the sections following rules (smodels format)
+ */
+
+void write_tables(FILE *out, ATAB *table)
+{
+  write_symbols(STYLE_SMODELS, out, table);
+  fprintf(out, "0\n");
+
+  fprintf(out, "B+\n");
+  write_compute_statement(STYLE_SMODELS, out, table, MARK_TRUE);
+  fprintf(out, "0\n");
+
+  fprintf(out, "B-\n");
+  write_compute_statement(STYLE_SMODELS, out, table, MARK_FALSE);
+  fprintf(out, "0\n");
+
+  write_input(STYLE_SMODELS, out, table);
+
+  fprintf(out, "%i\n", 0);
+
+  return;
 }
 
 /* --------------------- Local transformation routines --------------------- */
@@ -237,47 +597,317 @@ int get_scc(int atom, OCCTAB *occtab)
     return 0;
 }
 
-int partition_head_by_sccs(int cnt, int *heads, OCCTAB *occtab)
+/* Collect the atoms in heads of rules to be shifted */
+
+int shifted_heads(RULE *program, int **heads)
+{
+  RULE *rule = NULL;
+  int cnt = 0;
+
+  for(rule = program; rule; rule = rule->next)
+    if(rule->type == TYPE_DISJUNCTIVE && get_head_cnt(rule)>1)
+      cnt += get_head_cnt(rule);
+
+  *heads = (int *)malloc((cnt+1)*sizeof(int));
+  cnt = 0;
+
+  for(rule = program; rule; rule = rule->next)
+    if(rule->type == TYPE_DISJUNCTIVE && get_head_cnt(rule)>1) {
+      memcpy(&(*heads)[cnt], get_heads(rule), get_head_cnt(rule)*sizeof(int));
+      cnt += get_head_cnt(rule);
+    }
+
+  return cnt;
+}
+
+/*
+ * radix_sort -- Sort indices stably by nonnegative keys (8 bits a time)
+ */
+
+void radix_sort(int cnt, int *index, int *key, int *tmp)
 {
+  int max_key = 0;
+  int shift = 0;
   int i = 0;
+
+  for(i=0; i<cnt; i++)
+    if(key[index[i]] > max_key)
+      max_key = key[index[i]];
+
+  for(shift=0; shift<32 && (max_key >> shift); shift += 8) {
+    int count[257];
+
+    memset(count, 0, sizeof(count));
+
+    for(i=0; i<cnt; i++)
+      count[((key[index[i]] >> shift) & 0xff) + 1]++;
+    for(i=1; i<257; i++)
+      count[i] += count[i-1];
+    for(i=0; i<cnt; i++)
+      tmp[count[(key[index[i]] >> shift) & 0xff]++] = index[i];
+
+    memcpy(index, tmp, cnt*sizeof(int));
+  }
+
+  return;
+}
+
+/*
+ * partition_head_by_sccs -- Make head atoms of each SCC contiguous
+ *
+ * Groups appear in the order of their first atoms and preserve the
+ * order of atoms in the head. SCC ids are looked up once per atom and
+ * then grouped by radix sorting; hence the time is linear in cnt.
+ */
+
+#define SMALL_HEAD 64
+
+int partition_head_by_sccs(int cnt, int *heads, OCCTAB *occtab)
+{
+  int local[3*SMALL_HEAD];
+  int *scratch = local;
+  int *key = NULL, *index = NULL, *tmp = NULL;
   int scc_cnt = 0;
+  int prev = 0;
+  int first = 0;
+  int i = 0;
+
+  if(!occtab || cnt < 2)      /* A single component */
+    return cnt > 0;
+
+  if(cnt > SMALL_HEAD)
+    scratch = (int *)malloc(3*cnt*sizeof(int));
+
+  key = scratch;
+  index = &scratch[cnt];
+  tmp = &scratch[2*cnt];
 
   for(i=0; i<cnt; i++) {
-    int scc = get_scc(heads[i], occtab);
-    int j = 0;
+    key[i] = get_scc(heads[i], occtab);
+    index[i] = i;
+  }
 
-    scc_cnt++;
+  radix_sort(cnt, index, key, tmp);
 
-    for(j=i+1; j<cnt; j++)
-      if(scc == get_scc(heads[j], occtab)) {
-	i++;
-	if(j>i) { /* We have to make a real move */
-	  int head = heads[j];
+  /* Re-key atoms by the first position of their SCC */
 
-	  heads[j] = heads[i];
-	  heads[i] = head;
-	}
-      }
+  for(i=0; i<cnt; i++) {
+    int scc = key[index[i]];
+
+    if(i == 0 || scc != prev) {
+      first = index[i];
+      scc_cnt++;
+    }
+    prev = scc;
+    key[index[i]] = first;
+  }
+
+  if(scc_cnt > 1) {
+    radix_sort(cnt, index, key, tmp);
+
+    for(i=0; i<cnt; i++)
+      tmp[i] = heads[index[i]];
+    memcpy(heads, tmp, cnt*sizeof(int));
   }
 
+  if(scratch != local)
+    free(scratch);
+
   return scc_cnt;
 }
 
+int compress_body(RULE *rule, int n, int no_bc, int force_bc)
+{
+  int body_cnt = get_pos_cnt(rule)+get_neg_cnt(rule);
+
+  return (!no_bc && (n-1)*body_cnt > n+3) || (force_bc && body_cnt>1);
+}
+
+/*
+ * Linear-size shifting (--lin) of a head split into n > 2 groups uses
+ * prefix atoms p_1, ..., p_{n-1} where p_i stands for some atom in the
+ * groups 1, ..., i being true and suffix atoms s_2, ..., s_n defined
+ * symmetrically. Then the shifted rule for group i has not p_{i-1} and
+ * not s_{i+1} rather than negations of all other head atoms.
+ */
+
+int chain_atoms(int n, int linear)
+{
+  if(linear && n > 2)
+    return 2*(n-1);
+  else
+    return 0;
+}
+
+/* Count the auxiliary atoms needed by shift_rule (in advance) */
+
+int count_new_atoms(RULE *program, RULE *end,
+		    int no_bc, int force_bc, int force, int linear,
+		    BODYTAB *bodies, OCCTAB *occtab)
+{
+  RULE *rule = program;
+  int cnt = 0;
+
+  while(rule != end) {
+    if(rule->type == TYPE_DISJUNCTIVE) {
+      int head_cnt = get_head_cnt(rule);
+
+      if(head_cnt>1) {
+	int n = partition_head_by_sccs(head_cnt, get_heads(rule), occtab);
+
+	if(!bodies && compress_body(rule, n, no_bc, force_bc))
+	  cnt++;
+	cnt += chain_atoms(force ? head_cnt : n, linear);
+      }
+    }
+    rule = rule->next;
+  }
+
+  return cnt;
+}
+
+/*
+ * share_bodies -- Decide which bodies are shared by shifted rules
+ *
+ * A body of b literals is repeated in each of the n rules resulting from
+ * shifting a rule. An atom standing for the body saves n*(b-1) literals
+ * per rule while its defining rule costs b+1 literals once. Hence the
+ * literals saved are summed over all rules having the body. The atoms
+ * are numbered from newatom in the order of first occurrences.
+ */
+
+BODYTAB *share_bodies(RULE *program, int force_bc, int force, OCCTAB *occtab,
+		      int newatom, SHARESTATS *stats)
+{
+  BODYTAB *bodies = NULL;
+  BODY **order = NULL;    /* Bodies in the order of first occurrences */
+  RULE *rule = NULL;
+  int body_cnt = 0;
+  int i = 0;
+
+  for(rule = program; rule; rule = rule->next)
+    body_cnt++;
+
+  bodies = new_body_table(body_cnt);
+  order = (BODY **)malloc(body_cnt*sizeof(BODY *));
+  body_cnt = 0;
+
+  for(rule = program; rule; rule = rule->next)
+    if(rule->type == TYPE_DISJUNCTIVE && get_head_cnt(rule)>1) {
+      int head_cnt = get_head_cnt(rule);
+      int n = partition_head_by_sccs(head_cnt, get_heads(rule), occtab);
+      BODY *body = share_body(bodies, rule);
+      int b = body->pos_cnt + body->neg_cnt;
+
+      if(body->uses++ == 0)
+	order[body_cnt++] = body;
+      body->saved += (force ? head_cnt : n)*(b-1);
+    }
+
+  for(i=0; i<body_cnt; i++) {
+    BODY *body = order[i];
+    int b = body->pos_cnt + body->neg_cnt;
+
+    if(b>1 && (force_bc || body->saved > b+1)) {
+      body->atom = newatom + stats->bodies++;
+      stats->rules += body->uses;
+    }
+  }
+
+  free(order);
+
+  return bodies;
+}
+
+/* Shift the rules from program up to (but excluding) end */
+
+int shift_rules(int style, FILE *out, RULE *program, RULE *end,
+		int no_bc, int force_bc, int force, int linear, BODYTAB *bodies,
+		ATAB *table, OCCTAB *occtab, int newatom, int verbose)
+{
+  RULE *rule = program;
+
+  while(rule != end) {
+    if(rule->type == TYPE_DISJUNCTIVE) {
+      int head_cnt = get_head_cnt(rule);
+
+      if(head_cnt>1)
+	newatom = shift_rule(style, out, rule, no_bc, force_bc, force, linear,
+			     bodies, table, occtab, newatom, verbose);
+      else
+	transform_into_basic(style, out, rule, table);
+    } else
+      write_rule_as(style, out, rule, table);
+
+    rule = rule->next;
+  }
+
+  return newatom;
+}
+
+/* Write a rule head :- body. for the linear-size encoding */
+
+void write_link(int style, FILE *out, int head, int body, ATAB *table)
+{
+  RULE link;
+  BASIC_RULE basic;
+
+  basic.head = head;
+  basic.pos_cnt = 1;
+  basic.pos = &body;
+  basic.neg_cnt = 0;
+  basic.neg = NULL;
+
+  link.type = TYPE_BASIC;
+  link.data.basic = &basic;
+  link.next = NULL;
+
+  write_rule_as(style, out, &link, table);
+
+  return;
+}
+
+/* Write a rule joint :- body. where the body is that of rule */
+
+void write_joint_body(int style, FILE *out, int joint, RULE *rule, ATAB *table)
+{
+  RULE jbody;
+  BASIC_RULE basic;
+
+  basic.head = joint;
+  basic.pos_cnt = get_pos_cnt(rule);
+  basic.pos = get_pos(rule);
+  basic.neg_cnt = get_neg_cnt(rule);
+  basic.neg = get_neg(rule);
+
+  jbody.type = TYPE_BASIC;
+  jbody.data.basic = &basic;
+  jbody.next = NULL;
+
+  write_rule_as(style, out, &jbody, table);
+
+  return;
+}
+
 /* Do shifting for rules that have at least two head atoms */
 
 int shift_rule(int style, FILE *out, RULE *rule,
-	       int no_bc, int force_bc, int force,
+	       int no_bc, int force_bc, int force, int linear, BODYTAB *bodies,
 	       ATAB *table, OCCTAB *occtab, int newatom, int verbose)
 {
   int *heads = get_heads(rule);
   int head_cnt = get_head_cnt(rule);
   int n = partition_head_by_sccs(head_cnt, heads, occtab);
+  int groups = force ? head_cnt : n;
   int scc = 0;
   int i = 0;
+  int group = 0;
   RULE *shifted = NULL;
   DISJUNCTIVE_RULE *disjunctive = NULL;
   BASIC_RULE *basic = NULL;
   int joint_body = 0;
+  int prefix = 0;      /* p_1 (if any) */
+  int suffix = 0;      /* s_2 (if any) */
 
   if(!force)
     scc = get_scc(heads[0], occtab);
@@ -296,36 +926,44 @@ int shift_rule(int style, FILE *out, RULE *rule,
   basic = (BASIC_RULE *)malloc(sizeof(BASIC_RULE));
   basic-> neg = NULL;
 
-  if((!no_bc &&
-      (n-1)*(get_pos_cnt(rule)+get_neg_cnt(rule)) > n+3)
-     ||
-     (force_bc && get_pos_cnt(rule)+get_neg_cnt(rule)>1))
-  {
-    RULE *jbody = (RULE *)malloc(sizeof(RULE));
-    BASIC_RULE *joint = (BASIC_RULE *)malloc(sizeof(BASIC_RULE));
+  if(bodies) {
+    BODY *body = NULL;
 
-    extend_table(table, 1, newatom-1);
-    joint_body = newatom++;
+    if(get_pos_cnt(rule)+get_neg_cnt(rule) > 1)
+      body = find_body(bodies, rule);
 
-    jbody->type = TYPE_BASIC;
-    jbody->data.basic = joint;
-    jbody->next = NULL;
+    if(body && body->atom) {
+      joint_body = body->atom;
 
-    joint->head = joint_body;
-    joint->pos_cnt = get_pos_cnt(rule);
-    joint->pos = get_pos(rule);
-    joint->neg_cnt = get_neg_cnt(rule);
-    joint->neg = get_neg(rule);
+      /* The body is defined where it occurs first */
 
-    write_rule(style, out, jbody, table);
+      if(body->first == rule)
+	write_joint_body(style, out, joint_body, rule, table);
+    }
+
+  } else if(compress_body(rule, n, no_bc, force_bc)) {
+
+    /* The atom has been reserved by count_new_atoms */
+
+    joint_body = newatom++;
+
+    write_joint_body(style, out, joint_body, rule, table);
+  }
 
-    free(jbody);
-    free(joint);
+  if(chain_atoms(groups, linear)) {
+    prefix = newatom;
+    suffix = newatom+groups-1;
+    newatom += 2*(groups-1);
   }
 
   while(i<head_cnt) {
     int j = i;
     int new_head_cnt = 0;
+    int neg_cnt = joint_body ? 0 : get_neg_cnt(rule);
+    int *neg = get_neg(rule);
+    int new_cnt = 0;
+    int *new_neg = NULL;
+    int k = 0, l = 0;
 
     if(!force)
       while(j<head_cnt && scc == get_scc(heads[j], occtab)) j++;
@@ -345,61 +983,60 @@ int shift_rule(int style, FILE *out, RULE *rule,
       disjunctive->head = &heads[i];
     }
 
-    if(joint_body) {
-      int new_cnt = head_cnt - new_head_cnt;
-      int *new_neg = (int *)malloc(new_cnt*sizeof(int));
-      int k = 0, l = 0;
+    /* Negate the other head atoms or the chain atoms covering them */
 
-      for(l=0; l<i; l++)
-	  new_neg[k++] = heads[l];
-      for(l=j; l<head_cnt; l++)
-	  new_neg[k++] = heads[l];
-
-      if(new_head_cnt == 1) {
-	basic->pos_cnt = 1;
-	basic->pos = &joint_body;
-	basic->neg_cnt = new_cnt;
-	basic->neg = new_neg;
-      } else {
-	disjunctive->pos_cnt = 1;
-	disjunctive->pos = &joint_body;
-	disjunctive->neg_cnt = new_cnt;
-	disjunctive->neg = new_neg;
+    if(prefix) {
+      new_cnt = neg_cnt + (group>0) + (group<groups-1);
+      new_neg = (int *)malloc(new_cnt*sizeof(int));
+
+      for(k=0; k<neg_cnt; k++)
+	new_neg[k] = neg[k];
+      if(group>0)
+	new_neg[k++] = prefix+group-1;
+      if(group<groups-1)
+	new_neg[k++] = suffix+group;
+
+      /* Define p_{group+1} and s_{group+1} using atoms of the group */
+
+      for(l=i; l<j; l++) {
+	if(group<groups-1)
+	  write_link(style, out, prefix+group, heads[l], table);
+	if(group>0)
+	  write_link(style, out, suffix+group-1, heads[l], table);
+      }
+      if(group>0 && group<groups-1) {
+	write_link(style, out, prefix+group, prefix+group-1, table);
+	write_link(style, out, suffix+group-1, suffix+group, table);
       }
     } else {
-      int neg_cnt = get_neg_cnt(rule);
-      int new_cnt = neg_cnt + head_cnt - (j-i);
-      int *neg = get_neg(rule);
-      int *new_neg = (int *)malloc(new_cnt*sizeof(int));
-      int k = 0, l = 0;
+      new_cnt = neg_cnt + head_cnt - new_head_cnt;
+      new_neg = (int *)malloc(new_cnt*sizeof(int));
 
       for(k=0; k<neg_cnt; k++)
 	new_neg[k] = neg[k];
       for(l=0; l<i; l++)
-	  new_neg[k++] = heads[l];
+	new_neg[k++] = heads[l];
       for(l=j; l<head_cnt; l++)
-	  new_neg[k++] = heads[l];
-
-      if(new_head_cnt == 1) {
-	basic->pos_cnt = get_pos_cnt(rule);
-	basic->pos = get_pos(rule);
-	basic->neg_cnt = new_cnt;
-	basic->neg = new_neg;
-      } else {
-	disjunctive->pos_cnt = get_pos_cnt(rule);
-	disjunctive->pos = get_pos(rule);
-	disjunctive->neg_cnt = new_cnt;
-	disjunctive->neg = new_neg;
-      }
+	new_neg[k++] = heads[l];
+    }
+
+    if(new_head_cnt == 1) {
+      basic->pos_cnt = joint_body ? 1 : get_pos_cnt(rule);
+      basic->pos = joint_body ? &joint_body : get_pos(rule);
+      basic->neg_cnt = new_cnt;
+      basic->neg = new_neg;
+    } else {
+      disjunctive->pos_cnt = joint_body ? 1 : get_pos_cnt(rule);
+      disjunctive->pos = joint_body ? &joint_body : get_pos(rule);
+      disjunctive->neg_cnt = new_cnt;
+      disjunctive->neg = new_neg;
     }
 
-    write_rule(style, out, shifted, table);
+    write_rule_as(style, out, shifted, table);
 
-    if(new_head_cnt == 1)
-      free(basic->neg);
-    else
-      free(disjunctive->neg);
+    free(new_neg);
 
+    group++;
     i=j;
     if(i<head_cnt) scc = get_scc(heads[i], occtab);
   }
@@ -411,6 +1048,142 @@ int shift_rule(int style, FILE *out, RULE *rule,
   return newatom;
 }
 
+/* --------------------------- Parallel shifting --------------------------- */
+
+/*
+ * Rules are divided into consecutive chunks, one per thread. The new
+ * atoms of each chunk are counted first so that every chunk knows its
+ * first auxiliary atom (a prefix sum of the counts). Then the chunks are
+ * shifted into memory buffers which are written in the original order.
+ * Hence the output is identical to that of a sequential run.
+ */
+
+typedef struct shiftjob {
+  RULE *first, *end;         /* Rules of the chunk */
+  int style;
+  int no_bc, force_bc, force, linear, verbose;
+  BODYTAB *bodies;
+  ATAB *table;
+  OCCTAB *occtab;
+  int aux_cnt;               /* New atoms needed by the chunk */
+  int newatom;               /* The first of them */
+  char *buffer;              /* Shifted rules */
+  size_t size;
+} SHIFTJOB;
+
+void *count_chunk(void *arg)
+{
+  SHIFTJOB *job = (SHIFTJOB *)arg;
+
+  job->aux_cnt = count_new_atoms(job->first, job->end,
+				 job->no_bc, job->force_bc, job->force,
+				 job->linear, job->bodies, job->occtab);
+
+  return NULL;
+}
+
+void *shift_chunk(void *arg)
+{
+  SHIFTJOB *job = (SHIFTJOB *)arg;
+  FILE *out = open_memstream(&job->buffer, &job->size);
+
+  if(out == NULL) {
+    fprintf(stderr, "%s: cannot allocate an output buffer\n", program_name);
+    exit(-1);
+  }
+
+  shift_rules(job->style, out, job->first, job->end,
+	      job->no_bc, job->force_bc, job->force, job->linear, job->bodies,
+	      job->table, job->occtab, job->newatom, job->verbose);
+  fclose(out);
+
+  return NULL;
+}
+
+void run_jobs(int cnt, SHIFTJOB *jobs, void *(*routine)(void *))
+{
+  pthread_t *threads = (pthread_t *)malloc(cnt*sizeof(pthread_t));
+  int i = 0;
+
+  for(i=0; i<cnt; i++)
+    if(pthread_create(&threads[i], NULL, routine, &jobs[i])) {
+      fprintf(stderr, "%s: cannot create a thread\n", program_name);
+      exit(-1);
+    }
+
+  for(i=0; i<cnt; i++)
+    pthread_join(threads[i], NULL);
+
+  free(threads);
+
+  return;
+}
+
+int shift_in_parallel(int threads, int style, FILE *out, RULE *program,
+		      int no_bc, int force_bc, int force, int linear,
+		      BODYTAB *bodies, ATAB *table, OCCTAB *occtab,
+		      int newatom, int verbose)
+{
+  SHIFTJOB *jobs = NULL;
+  RULE *rule = NULL;
+  int rule_cnt = 0;
+  int per_job = 0;
+  int cnt = 0;
+  int aux_cnt = 0;
+  int i = 0;
+
+  for(rule = program; rule; rule = rule->next)
+    rule_cnt++;
+
+  per_job = (rule_cnt + threads - 1)/threads;
+  if(per_job == 0)
+    per_job = 1;
+
+  /* Divide rules into chunks of (at most) per_job rules */
+
+  jobs = (SHIFTJOB *)calloc(threads, sizeof(SHIFTJOB));
+
+  for(rule = program; rule; cnt++) {
+    SHIFTJOB *job = &jobs[cnt];
+
+    job->first = rule;
+    for(i=0; i<per_job && rule; i++)
+      rule = rule->next;
+    job->end = rule;
+
+    job->style = style;
+    job->no_bc = no_bc;
+    job->force_bc = force_bc;
+    job->force = force;
+    job->linear = linear;
+    job->bodies = bodies;
+    job->verbose = verbose;
+    job->table = table;
+    job->occtab = occtab;
+  }
+
+  run_jobs(cnt, jobs, count_chunk);
+
+  for(i=0; i<cnt; i++) {
+    jobs[i].newatom = newatom + aux_cnt;
+    aux_cnt += jobs[i].aux_cnt;
+  }
+
+  if(aux_cnt)
+    extend_table(table, aux_cnt, newatom-1);
+
+  run_jobs(cnt, jobs, shift_chunk);
+
+  for(i=0; i<cnt; i++) {
+    fwrite(jobs[i].buffer, 1, jobs[i].size, out);
+    free(jobs[i].buffer);
+  }
+
+  free(jobs);
+
+  return newatom + aux_cnt;
+}
+
 /*
  * transform_into_basic -- Transform a single-headed disjunctive rule
  */
@@ -430,10 +1203,419 @@ void transform_into_basic(int style, FILE *out, RULE *rule, ATAB *table)
   basic->neg_cnt = disjunctive->neg_cnt;
   basic->neg = disjunctive->neg;
 
-  write_rule(style, out, new, table);
+  write_rule_as(style, out, new, table);
 
   free(new);
   free(basic);
 
   return;
 }
+
+/* ----------------------- Streaming of forced shifts ---------------------- */
+
+/*
+ * New atoms cannot be numbered before the symbol table
+ * following the rules has been read. Until then, they are given
+ * negative placeholders starting from STREAM_BASE which are finally
+ * remapped to the atoms following the largest atom of the input.
+ */
+
+#define STREAM_BASE (INT_MIN/2)
+
+int *read_atom_list(FILE *in, int cnt, int *size, int *atoms)
+{
+  int i = 0;
+
+  if(cnt > *size) {
+    *size = 2*cnt;
+    atoms = (int *)realloc(atoms, (*size)*sizeof(int));
+  }
+
+  for(i=0; i<cnt; i++)
+    if(fscanf(in, "%i", &atoms[i]) != 1) {
+      fprintf(stderr, "%s: premature end of rule!\n", program_name);
+      exit(-1);
+    }
+
+  return atoms;
+}
+
+int copy_number(FILE *in, FILE *out)
+{
+  int number = 0;
+
+  if(fscanf(in, "%i", &number) != 1) {
+    fprintf(stderr, "%s: premature end of rule!\n", program_name);
+    exit(-1);
+  }
+  fprintf(out, " %i", number);
+
+  return number;
+}
+
+int copy_atoms(FILE *in, FILE *out, int cnt, int max_atom)
+{
+  int i = 0;
+
+  for(i=0; i<cnt; i++) {
+    int atom = copy_number(in, out);
+
+    if(atom > max_atom)
+      max_atom = atom;
+  }
+
+  return max_atom;
+}
+
+int max_atom_of(int cnt, int *atoms, int max_atom)
+{
+  int i = 0;
+
+  for(i=0; i<cnt; i++)
+    if(atoms[i] > max_atom)
+      max_atom = atoms[i];
+
+  return max_atom;
+}
+
+/*
+ * copy_rule -- Pass a non-disjunctive rule through and keep track of the
+ *              largest atom (the symbol table need not cover all atoms)
+ */
+
+int copy_rule(FILE *in, FILE *out, int type, int max_atom)
+{
+  int cnt = 0;
+  int i = 0;
+
+  fprintf(out, "%i", type);
+
+  switch(type) {
+  case TYPE_BASIC:
+    max_atom = copy_atoms(in, out, 1, max_atom);
+    cnt = copy_number(in, out);
+    copy_number(in, out);
+    max_atom = copy_atoms(in, out, cnt, max_atom);
+    break;
+
+  case TYPE_CONSTRAINT:
+    max_atom = copy_atoms(in, out, 1, max_atom);
+    cnt = copy_number(in, out);
+    copy_number(in, out);
+    copy_number(in, out);
+    max_atom = copy_atoms(in, out, cnt, max_atom);
+    break;
+
+  case TYPE_CHOICE:
+    cnt = copy_number(in, out);
+    max_atom = copy_atoms(in, out, cnt, max_atom);
+    cnt = copy_number(in, out);
+    copy_number(in, out);
+    max_atom = copy_atoms(in, out, cnt, max_atom);
+    break;
+
+  case TYPE_WEIGHT:
+    max_atom = copy_atoms(in, out, 1, max_atom);
+    copy_number(in, out);
+    cnt = copy_number(in, out);
+    copy_number(in, out);
+    max_atom = copy_atoms(in, out, cnt, max_atom);
+    for(i=0; i<cnt; i++)
+      copy_number(in, out);
+    break;
+
+  case TYPE_OPTIMIZE:
+    copy_number(in, out);
+    cnt = copy_number(in, out);
+    copy_number(in, out);
+    max_atom = copy_atoms(in, out, cnt, max_atom);
+    for(i=0; i<cnt; i++)
+      copy_number(in, out);
+    break;
+
+  default:
+    fprintf(stderr, "%s: rule type %i not supported!\n", program_name, type);
+    exit(-1);
+  }
+
+  fprintf(out, "\n");
+
+  return max_atom;
+}
+
+void remap_placeholders(FILE *in, FILE *out, int size)
+{
+  int c = 0;
+
+  while((c = getc(in)) != EOF) {
+    if(c == '-') {
+      int atom = 0;
+
+      fscanf(in, "%i", &atom);
+      fprintf(out, "%i", size+1-atom-STREAM_BASE);
+    } else
+      putc(c, out);
+  }
+
+  return;
+}
+
+/*
+ * stream_shift -- Shift rules (-f) as they are read using bounded memory
+ */
+
+void stream_shift(FILE *in, FILE *out, int no_bc, int force_bc, int linear)
+{
+  FILE *rules = out;
+  ATAB *table = NULL;
+  RULE rule;
+  DISJUNCTIVE_RULE disjunctive;
+  int size = 0, head_size = 0, neg_size = 0, pos_size = 0;
+  int *heads = NULL, *neg = NULL, *pos = NULL;
+  int newatom = STREAM_BASE;
+  int max_atom = 0;
+  int type = 0;
+
+  /* Rules must be buffered only if new atoms may be introduced */
+
+  if((!no_bc || linear) && (rules = tmpfile()) == NULL) {
+    fprintf(stderr, "%s: cannot create a temporary file\n", program_name);
+    exit(-1);
+  }
+
+  rule.type = TYPE_DISJUNCTIVE;
+  rule.data.disjunctive = &disjunctive;
+  rule.next = NULL;
+
+  while(fscanf(in, "%i", &type) == 1 && type != 0) {
+    if(type == TYPE_DISJUNCTIVE) {
+      int body_cnt = 0;
+
+      fscanf(in, "%i", &disjunctive.head_cnt);
+      heads = read_atom_list(in, disjunctive.head_cnt, &head_size, heads);
+      fscanf(in, "%i", &body_cnt);
+      fscanf(in, "%i", &disjunctive.neg_cnt);
+      neg = read_atom_list(in, disjunctive.neg_cnt, &neg_size, neg);
+      disjunctive.pos_cnt = body_cnt - disjunctive.neg_cnt;
+      pos = read_atom_list(in, disjunctive.pos_cnt, &pos_size, pos);
+
+      disjunctive.head = heads;
+      disjunctive.neg = neg;
+      disjunctive.pos = pos;
+
+      max_atom = max_atom_of(disjunctive.head_cnt, heads, max_atom);
+      max_atom = max_atom_of(disjunctive.neg_cnt, neg, max_atom);
+      max_atom = max_atom_of(disjunctive.pos_cnt, pos, max_atom);
+
+      if(disjunctive.head_cnt>1)
+	newatom = shift_rule(STYLE_SMODELS, rules, &rule, no_bc, force_bc, 1,
+			     linear, NULL, NULL, NULL, newatom, 0);
+      else
+	transform_into_basic(STYLE_SMODELS, rules, &rule, NULL);
+    } else
+      max_atom = copy_rule(in, rules, type, max_atom);
+  }
+
+  if(type != 0) {
+    fprintf(stderr, "%s: premature end of rules!\n", program_name);
+    exit(-1);
+  }
+
+  table = read_symbols(in);
+  read_compute_statement(in, table);
+
+  /* New atoms follow all atoms whether named or not */
+
+  size = table_size(table);
+  if(max_atom > size) {
+    extend_table(table, max_atom-size, size);
+    size = max_atom;
+  }
+
+  if(rules != out) {
+    rewind(rules);
+    remap_placeholders(rules, out, size);
+    fclose(rules);
+  }
+  fprintf(out, "0\n");
+
+  if(newatom > STREAM_BASE)
+    extend_table(table, newatom-STREAM_BASE, size);
+
+  write_tables(out, table);
+
+  free(heads);
+  free(neg);
+  free(pos);
+
+  return;
+}
+
+/* ------------------------------- Batch mode ------------------------------ */
+
+/*
+ * Programs listed in a batch are shifted by worker processes which take
+ * the numbers of jobs from a shared pipe. Each worker shifts programs
+ * one after another reusing its heap. Processes rather than threads are
+ * used, since the symbol table maintained by liblp is global.
+ */
+
+char *read_word(FILE *in)
+{
+  int size = 64;
+  char *word = NULL;
+  int len = 0;
+  int c = 0;
+
+  while((c = getc(in)) != EOF && (c == ' ' || c == '\t' || c == '\n'))
+    ;
+
+  if(c == EOF)
+    return NULL;
+
+  word = (char *)malloc(size);
+
+  do {
+    if(len+1 == size) {
+      size *= 2;
+      word = (char *)realloc(word, size);
+    }
+    word[len++] = c;
+  } while((c = getc(in)) != EOF && c != ' ' && c != '\t' && c != '\n');
+
+  word[len] = '\0';
+
+  return word;
+}
+
+int shift_file(char *input, char *output,
+	       int force, int verbose, int no_bc, int force_bc,
+	       int normalize, int simplify, int threads, int linear, int share,
+	       int aspif)
+{
+  FILE *in = NULL;
+  FILE *out = NULL;
+
+  if((in = fopen(input, "r")) == NULL) {
+    fprintf(stderr, "%s: cannot open file %s\n", program_name, input);
+    return -1;
+  }
+
+  if((out = fopen(output, "w")) == NULL) {
+    fprintf(stderr, "%s: cannot create file %s\n", program_name, output);
+    fclose(in);
+    return -1;
+  }
+
+  shift_program(in, out, force, verbose, no_bc, force_bc,
+		normalize, simplify, threads, linear, share, NULL, aspif);
+
+  fclose(in);
+  fclose(out);
+
+  return 0;
+}
+
+void batch_shift(FILE *list, int workers,
+		 int force, int verbose, int no_bc, int force_bc,
+		 int normalize, int simplify, int threads, int linear, int share,
+		 int aspif)
+{
+  int size = 32;
+  char **files = (char **)malloc(size*sizeof(char *));
+  char *file = NULL;
+  int cnt = 0;
+  int jobs[2];
+  int failed = 0;
+  int undispatched = 0;
+  void (*pipe_handler)(int) = NULL;
+  int i = 0;
+
+  while((file = read_word(list))) {
+    if(cnt == size) {
+      size *= 2;
+      files = (char **)realloc(files, size*sizeof(char *));
+    }
+    files[cnt++] = file;
+  }
+
+  if(cnt % 2) {
+    fprintf(stderr, "%s: no output file given for %s\n",
+	    program_name, files[cnt-1]);
+    exit(-1);
+  }
+
+  if(pipe(jobs)) {
+    fprintf(stderr, "%s: cannot create a pipe\n", program_name);
+    exit(-1);
+  }
+
+  fflush(NULL);
+
+  for(i=0; i<workers; i++) {
+    pid_t pid = fork();
+
+    if(pid < 0) {
+      fprintf(stderr, "%s: cannot create a worker process\n", program_name);
+      exit(-1);
+    }
+
+    if(pid == 0) {
+      int job = 0;
+      int status = 0;
+
+      close(jobs[1]);
+
+      while(read(jobs[0], &job, sizeof(int)) == sizeof(int))
+	if(shift_file(files[2*job], files[2*job+1],
+		      force, verbose, no_bc, force_bc,
+		      normalize, simplify, threads, linear, share, aspif))
+	  status = -1;
+
+      exit(status);
+    }
+  }
+
+  close(jobs[0]);
+
+  /* If all workers have died, writing fails with EPIPE (not SIGPIPE)
+     so that the failures can still be collected and reported */
+
+  pipe_handler = signal(SIGPIPE, SIG_IGN);
+
+  for(i=0; i<cnt/2; i++)
+    if(write(jobs[1], &i, sizeof(int)) != sizeof(int)) {
+      fprintf(stderr, "%s: cannot dispatch jobs\n", program_name);
+      undispatched = cnt/2-i;
+      break;
+    }
+
+  close(jobs[1]);
+  signal(SIGPIPE, pipe_handler);
+
+  for(i=0; i<workers; i++) {
+    int status = 0;
+
+    wait(&status);
+    if(!WIFEXITED(status) || WEXITSTATUS(status))
+      failed++;
+  }
+
+  if(failed) {
+    fprintf(stderr, "%s: %i out of %i workers failed\n",
+	    program_name, failed, workers);
+    exit(-1);
+  }
+
+  if(undispatched) {
+    fprintf(stderr, "%s: %i out of %i jobs not dispatched\n",
+	    program_name, undispatched, cnt/2);
+    exit(-1);
+  }
+
+  for(i=0; i<cnt; i++)
+    free(files[i]);
+  free(files);
+
+  return;
+}
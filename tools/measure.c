@@ -0,0 +1,92 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * MEASURE -- Wall time and peak memory of a command (used by bench.sh)
+ *
+ * (c) 2026 Tomi Janhunen
+ *
+ * Usage: measure <output file> <command> <arguments> ...
+ *
+ * The standard output of the command goes to the output file, and the
+ * wall time in seconds and the peak resident set size in kilobytes are
+ * printed on the standard output.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+int main(int argc, char **argv)
+{
+  struct timeval start, end;
+  struct rusage usage;
+  int status = 0;
+  pid_t pid = 0;
+
+  if(argc < 3) {
+    fprintf(stderr, "usage: %s <output file> <command> <arguments> ...\n",
+	    argv[0]);
+    exit(-1);
+  }
+
+  gettimeofday(&start, NULL);
+
+  pid = fork();
+
+  if(pid < 0) {
+    fprintf(stderr, "%s: cannot create a process\n", argv[0]);
+    exit(-1);
+  }
+
+  if(pid == 0) {
+    int fd = open(argv[1], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if(fd < 0 || dup2(fd, 1) < 0) {
+      fprintf(stderr, "%s: cannot create file %s\n", argv[0], argv[1]);
+      exit(-1);
+    }
+    close(fd);
+
+    execvp(argv[2], &argv[2]);
+    fprintf(stderr, "%s: cannot execute %s\n", argv[0], argv[2]);
+    exit(-1);
+  }
+
+  if(wait4(pid, &status, 0, &usage) < 0) {
+    fprintf(stderr, "%s: cannot wait for %s\n", argv[0], argv[2]);
+    exit(-1);
+  }
+
+  gettimeofday(&end, NULL);
+
+  printf("%.6f %li\n",
+	 (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec)/1e6,
+	 (long)usage.ru_maxrss);
+
+  if(!WIFEXITED(status) || WEXITSTATUS(status))
+    exit(-1);
+
+  exit(0);
+}
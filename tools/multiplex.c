@@ -0,0 +1,413 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Reading modules from several streams at once (lpcat -r -p)
+ *
+ * (c) 2026 Tomi Janhunen
+ *
+ * Pipes and FIFOs are watched by epoll, and regular files are read as
+ * if always ready. The bytes of each stream are scanned line by line to
+ * find where a module ends, and complete modules are passed on as
+ * memory streams to be parsed by liblp as usual.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+
+#include "version.h"
+#include "symbol.h"
+#include "multiplex.h"
+
+void _version_multiplex_c()
+{
+  _version("$RCSfile: multiplex.c,v $",
+	   "$Date: 2026/10/18 22:00:00 $",
+	   "$Revision: 1.1 $");
+}
+
+/* Sections of a module: rules, symbols, B+, B-, E (SMODELS format),
+   the number of models, or the statements of the aspif format */
+
+#define MUX_START      0
+#define MUX_RULES      1
+#define MUX_SYMBOLS    2
+#define MUX_BPLUS_HDR  3
+#define MUX_BPLUS      4
+#define MUX_BMINUS_HDR 5
+#define MUX_BMINUS     6
+#define MUX_AFTER      7    /* Either the E section or the number follows */
+#define MUX_INPUT      8
+#define MUX_MODELS     9
+#define MUX_ASPIF     10
+#define MUX_COMPLETE  11
+
+/* ------------------------- Opening streams ------------------------------- */
+
+MULTIPLEX *open_streams(int cnt, char **files, int order)
+{
+  MULTIPLEX *mux = (MULTIPLEX *)calloc(1, sizeof(MULTIPLEX));
+  int i = 0;
+
+  if(!mux || !(mux->streams = (MUXSTREAM *)calloc(cnt, sizeof(MUXSTREAM)))) {
+    fprintf(stderr, "%s: cannot allocate memory for streams\n",
+	    program_name);
+    exit(-1);
+  }
+
+  if((mux->epoll = epoll_create1(0)) < 0) {
+    fprintf(stderr, "%s: cannot create an epoll instance\n", program_name);
+    exit(-1);
+  }
+
+  mux->cnt = cnt;
+  mux->open = cnt;
+  mux->order = order;
+
+  for(i=0; i<cnt; i++) {
+    MUXSTREAM *s = &mux->streams[i];
+    struct epoll_event event;
+
+    s->file = files[i];
+
+    /* FIFOs are opened without waiting for their writers */
+
+    if(strcmp("-", files[i]) == 0)
+      s->fd = 0;
+    else if((s->fd = open(files[i], O_RDONLY | O_NONBLOCK)) < 0) {
+      fprintf(stderr, "%s: cannot open file %s\n", program_name, files[i]);
+      exit(-1);
+    }
+    fcntl(s->fd, F_SETFL, fcntl(s->fd, F_GETFL) | O_NONBLOCK);
+
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u32 = i;
+
+    if(epoll_ctl(mux->epoll, EPOLL_CTL_ADD, s->fd, &event) == 0)
+      s->polled = -1;
+    else if(errno != EPERM) {  /* EPERM for regular files */
+      fprintf(stderr, "%s: cannot watch file %s\n", program_name, files[i]);
+      exit(-1);
+    }
+  }
+
+  return mux;
+}
+
+void close_streams(MULTIPLEX *mux)
+{
+  int i = 0;
+
+  for(i=0; i<mux->cnt; i++) {
+    if(!mux->streams[i].eof && mux->streams[i].fd)
+      close(mux->streams[i].fd);
+    free(mux->streams[i].buf);
+  }
+  for(i=0; i<mux->ready_cnt; i++)
+    free(mux->ready[(mux->ready_first+i) % mux->ready_size].text);
+
+  close(mux->epoll);
+  free(mux->ready);
+  free(mux->streams);
+  free(mux->current);
+  free(mux);
+
+  return;
+}
+
+/* ------------------------- Finding modules ------------------------------- */
+
+/* Compare a line (without the newline) with a word, neglecting spaces */
+
+int line_is(char *line, char *end, char *word)
+{
+  size_t len = strlen(word);
+
+  while(line < end && (*line == ' ' || *line == '\t' || *line == '\r'))
+    line++;
+  while(end > line && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+    end--;
+
+  return (size_t)(end-line) == len && strncmp(line, word, len) == 0;
+}
+
+int next_section(int state, char *line, char *end)
+{
+  int zero = line_is(line, end, "0");
+
+  if(line_is(line, end, ""))
+    return state;
+
+  switch(state) {
+  case MUX_START:
+    if(end-line >= 4 && strncmp(line, "asp ", 4) == 0)
+      return MUX_ASPIF;
+    return zero ? MUX_SYMBOLS : MUX_RULES;
+  case MUX_RULES:
+    return zero ? MUX_SYMBOLS : state;
+  case MUX_SYMBOLS:
+    return zero ? MUX_BPLUS_HDR : state;
+  case MUX_BPLUS_HDR:
+    return line_is(line, end, "B+") ? MUX_BPLUS : state;
+  case MUX_BPLUS:
+    return zero ? MUX_BMINUS_HDR : state;
+  case MUX_BMINUS_HDR:
+    return line_is(line, end, "B-") ? MUX_BMINUS : state;
+  case MUX_BMINUS:
+    return zero ? MUX_AFTER : state;
+  case MUX_AFTER:
+    return line_is(line, end, "E") ? MUX_INPUT : MUX_COMPLETE;
+  case MUX_INPUT:
+    return zero ? MUX_MODELS : state;
+  case MUX_MODELS:
+    return MUX_COMPLETE;
+  case MUX_ASPIF:
+    return zero ? MUX_COMPLETE : state;
+  }
+
+  return state;
+}
+
+void add_ready(MULTIPLEX *mux, char *text, size_t len, int stream)
+{
+  MUXMODULE *m = NULL;
+
+  if(mux->ready_cnt == mux->ready_size) {
+    int size = mux->ready_size ? 2*mux->ready_size : 16;
+    MUXMODULE *ready = (MUXMODULE *)malloc(size*sizeof(MUXMODULE));
+    int i = 0;
+
+    if(!ready) {
+      fprintf(stderr, "%s: cannot allocate memory for modules\n",
+	      program_name);
+      exit(-1);
+    }
+    for(i=0; i<mux->ready_cnt; i++)
+      ready[i] = mux->ready[(mux->ready_first+i) % mux->ready_size];
+    free(mux->ready);
+    mux->ready = ready;
+    mux->ready_first = 0;
+    mux->ready_size = size;
+  }
+
+  m = &mux->ready[(mux->ready_first+mux->ready_cnt) % mux->ready_size];
+  m->text = text;
+  m->len = len;
+  m->stream = stream;
+  mux->ready_cnt++;
+
+  return;
+}
+
+/* Scan the complete lines read from a stream for ends of modules */
+
+void scan_stream(MULTIPLEX *mux, int i)
+{
+  MUXSTREAM *s = &mux->streams[i];
+  char *line = NULL;
+  char *nl = NULL;
+
+  while(s->scanned < s->len &&
+	(nl = memchr(&s->buf[s->scanned], '\n', s->len-s->scanned))) {
+    line = &s->buf[s->scanned];
+    s->state = next_section(s->state, line, nl);
+    s->scanned = nl-s->buf+1;
+
+    if(s->state == MUX_COMPLETE) {
+      size_t len = s->scanned-s->start;
+      char *text = (char *)malloc(len);
+
+      if(!text) {
+	fprintf(stderr, "%s: cannot allocate memory for modules\n",
+		program_name);
+	exit(-1);
+      }
+      memcpy(text, &s->buf[s->start], len);
+      add_ready(mux, text, len, i);
+
+      s->start = s->scanned;
+      s->state = MUX_START;
+    }
+  }
+
+  /* Forget the modules passed on */
+
+  if(s->start > s->size/2) {
+    memmove(s->buf, &s->buf[s->start], s->len-s->start);
+    s->len -= s->start;
+    s->scanned -= s->start;
+    s->start = 0;
+  }
+
+  return;
+}
+
+/* Read what is available; returns 0 if nothing could be read yet */
+
+int read_stream(MULTIPLEX *mux, int i)
+{
+  MUXSTREAM *s = &mux->streams[i];
+  ssize_t got = 0;
+
+  if(s->len+MUX_CHUNK > s->size) {
+    s->size = s->size ? 2*s->size : 2*MUX_CHUNK;
+    while(s->len+MUX_CHUNK > s->size)
+      s->size *= 2;
+    if((s->buf = (char *)realloc(s->buf, s->size)) == NULL) {
+      fprintf(stderr, "%s: cannot allocate memory for file %s\n",
+	      program_name, s->file);
+      exit(-1);
+    }
+  }
+
+  got = read(s->fd, &s->buf[s->len], MUX_CHUNK);
+
+  if(got < 0) {
+    if(errno == EAGAIN || errno == EINTR)
+      return 0;
+    fprintf(stderr, "%s: cannot read file %s\n", program_name, s->file);
+    exit(-1);
+  }
+
+  if(got == 0) {  /* The end of the stream */
+    if(s->scanned < s->len) {  /* The last line lacks a newline */
+      s->buf[s->len++] = '\n';
+      scan_stream(mux, i);
+    }
+    if(s->state != MUX_START) {
+      fprintf(stderr, "%s: incomplete module at the end of file %s\n",
+	      program_name, s->file);
+      exit(-1);
+    }
+    if(s->polled)
+      epoll_ctl(mux->epoll, EPOLL_CTL_DEL, s->fd, NULL);
+    if(s->fd)
+      close(s->fd);
+    s->eof = -1;
+    mux->open--;
+    return -1;
+  }
+
+  s->len += got;
+  scan_stream(mux, i);
+
+  return -1;
+}
+
+/* Link modules completed together in the order of the files */
+
+void order_ready(MULTIPLEX *mux, int first)
+{
+  int i = 0, j = 0;
+
+  for(i=first+1; i<mux->ready_cnt; i++) {
+    MUXMODULE m = mux->ready[(mux->ready_first+i) % mux->ready_size];
+
+    for(j=i; j>first; j--) {
+      MUXMODULE *prev =
+	&mux->ready[(mux->ready_first+j-1) % mux->ready_size];
+
+      if(prev->stream <= m.stream)
+	break;
+      mux->ready[(mux->ready_first+j) % mux->ready_size] = *prev;
+    }
+    mux->ready[(mux->ready_first+j) % mux->ready_size] = m;
+  }
+
+  return;
+}
+
+/*
+ * next_module -- Wait for the next complete module from any stream
+ *
+ * The module is returned as a memory stream that remains valid until the
+ * next call; NULL is returned when all streams have ended.
+ */
+
+FILE *next_module(MULTIPLEX *mux)
+{
+  struct epoll_event events[64];
+  MUXMODULE m;
+  FILE *in = NULL;
+  int i = 0;
+
+  free(mux->current);
+  mux->current = NULL;
+
+  while(mux->ready_cnt == 0 && mux->open > 0) {
+    int first = mux->ready_cnt;
+    int unpolled = 0;
+    int cnt = 0;
+
+    /* Regular files are always ready */
+
+    for(i=0; i<mux->cnt; i++)
+      if(!mux->streams[i].polled && !mux->streams[i].eof) {
+	read_stream(mux, i);
+	unpolled = -1;
+      }
+
+    if(mux->open == 0 && mux->ready_cnt == 0)
+      break;
+
+    cnt = epoll_wait(mux->epoll, events, 64, unpolled ? 0 : -1);
+
+    if(cnt < 0 && errno != EINTR) {
+      fprintf(stderr, "%s: cannot wait for input\n", program_name);
+      exit(-1);
+    }
+
+    for(i=0; i<cnt; i++) {
+      MUXSTREAM *s = &mux->streams[events[i].data.u32];
+      int k = 0;
+
+      /* Read a bounded amount so that busy streams do not starve others;
+	 epoll reports the rest again */
+
+      while(k++ < MUX_ROUNDS && !s->eof &&
+	    read_stream(mux, events[i].data.u32))
+	;
+    }
+
+    if(mux->order == MUX_FILES)
+      order_ready(mux, first);
+  }
+
+  if(mux->ready_cnt == 0)
+    return NULL;
+
+  m = mux->ready[mux->ready_first];
+  mux->ready_first = (mux->ready_first+1) % mux->ready_size;
+  mux->ready_cnt--;
+
+  mux->current = m.text;
+  if((in = fmemopen(m.text, m.len, "r")) == NULL) {
+    fprintf(stderr, "%s: cannot read a module from file %s\n",
+	    program_name, mux->streams[m.stream].file);
+    exit(-1);
+  }
+
+  return in;
+}
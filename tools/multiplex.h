@@ -0,0 +1,76 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Reading modules from several streams at once (lpcat -r -p)
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+/* Version information */
+
+#define _MULTIPLEX_H_RCSFILE  "$RCSfile: multiplex.h,v $"
+#define _MULTIPLEX_H_DATE     "$Date: 2026/10/18 22:00:00 $"
+#define _MULTIPLEX_H_REVISION "$Revision: 1.1 $"
+
+extern void _version_multiplex_c();
+
+/* Orders of modules */
+
+#define MUX_ARRIVAL 1   /* As soon as complete */
+#define MUX_FILES   2   /* Modules completed together in the order of files */
+
+#define MUX_CHUNK   65536
+#define MUX_ROUNDS  16      /* Chunks read from a stream at a time */
+
+typedef struct muxstream {
+  char *file;
+  int fd;
+  int polled;           /* Watched by epoll (pipes, FIFOs, sockets) */
+  int eof;
+  char *buf;            /* Bytes read but not yet passed on */
+  size_t len;
+  size_t size;
+  size_t start;         /* Beginning of the current module */
+  size_t scanned;       /* Lines before this have been scanned */
+  int state;            /* Section of the current module */
+} MUXSTREAM;
+
+typedef struct muxmodule {
+  char *text;
+  size_t len;
+  int stream;
+} MUXMODULE;
+
+typedef struct multiplex {
+  int cnt;
+  MUXSTREAM *streams;
+  int open;             /* Streams not at EOF */
+  int epoll;
+  int order;
+  MUXMODULE *ready;     /* Complete modules waiting to be linked */
+  int ready_first;
+  int ready_cnt;
+  int ready_size;
+  char *current;        /* Text of the module being linked */
+} MULTIPLEX;
+
+extern MULTIPLEX *open_streams(int cnt, char **files, int order);
+extern FILE *next_module(MULTIPLEX *mux);
+extern void close_streams(MULTIPLEX *mux);
@@ -0,0 +1,452 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Normalization of rules: literals are sorted, duplicates are removed,
+ * weights are merged, and trivially satisfied/inapplicable rules dropped
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "version.h"
+#include "symbol.h"
+#include "atom.h"
+#include "rule.h"
+#include "io.h"
+#include "normalize.h"
+
+void _version_normalize_h()
+{
+  _version(_NORMALIZE_H_RCSFILE, _NORMALIZE_H_DATE, _NORMALIZE_H_REVISION);
+}
+
+void _version_normalize_c()
+{
+  _version_normalize_h();
+  _version("$RCSfile: normalize.c,v $",
+	   "$Date: 2026/10/18 10:00:00 $",
+	   "$Revision: 1.1 $");
+}
+
+#define SMALL_SPAN 16    /* Spans up to this length are insertion sorted */
+
+/* --------------------------- Sorting of literals -------------------------- */
+
+int compare_atoms(const void *a1, const void *a2)
+{
+  int atom1 = *(const int *)a1;
+  int atom2 = *(const int *)a2;
+
+  return (atom1 > atom2) - (atom1 < atom2);
+}
+
+void sort_atom_list(int cnt, int *atoms)
+{
+  int i = 0;
+
+  if(cnt > SMALL_SPAN) {
+    qsort(atoms, cnt, sizeof(int), compare_atoms);
+    return;
+  }
+
+  /* Short spans are typical: insertion sort without any calls */
+
+  for(i=1; i<cnt; i++) {
+    int atom = atoms[i];
+    int j = i;
+
+    while(j>0 && atoms[j-1] > atom) {
+      atoms[j] = atoms[j-1];
+      j--;
+    }
+    atoms[j] = atom;
+  }
+
+  return;
+}
+
+typedef struct wlit {
+  int atom;
+  int weight;
+} WLIT;
+
+int compare_wlits(const void *l1, const void *l2)
+{
+  int atom1 = ((const WLIT *)l1)->atom;
+  int atom2 = ((const WLIT *)l2)->atom;
+
+  return (atom1 > atom2) - (atom1 < atom2);
+}
+
+void sort_weighted_list(int cnt, int *atoms, int *weights)
+{
+  int i = 0;
+
+  if(cnt > SMALL_SPAN) {
+    WLIT *lits = (WLIT *)malloc(cnt*sizeof(WLIT));
+
+    for(i=0; i<cnt; i++) {
+      lits[i].atom = atoms[i];
+      lits[i].weight = weights[i];
+    }
+
+    qsort(lits, cnt, sizeof(WLIT), compare_wlits);
+
+    for(i=0; i<cnt; i++) {
+      atoms[i] = lits[i].atom;
+      weights[i] = lits[i].weight;
+    }
+
+    free(lits);
+    return;
+  }
+
+  for(i=1; i<cnt; i++) {
+    int atom = atoms[i];
+    int weight = weights[i];
+    int j = i;
+
+    while(j>0 && atoms[j-1] > atom) {
+      atoms[j] = atoms[j-1];
+      weights[j] = weights[j-1];
+      j--;
+    }
+    atoms[j] = atom;
+    weights[j] = weight;
+  }
+
+  return;
+}
+
+/* -------------------- Removal of duplicates (in place) -------------------- */
+
+int unique_atom_list(int cnt, int *atoms, NORMSTATS *stats)
+{
+  int i = 0, j = 0;
+
+  sort_atom_list(cnt, atoms);
+
+  for(i=0; i<cnt; i++)
+    if(j == 0 || atoms[j-1] != atoms[i])
+      atoms[j++] = atoms[i];
+
+  stats->literals += cnt-j;
+
+  return j;
+}
+
+int merge_weighted_list(int cnt, int *atoms, int *weights, NORMSTATS *stats)
+{
+  int i = 0, j = 0;
+
+  sort_weighted_list(cnt, atoms, weights);
+
+  for(i=0; i<cnt; i++)
+    if(j && atoms[j-1] == atoms[i]) {
+      weights[j-1] += weights[i];
+      stats->merged++;
+    } else {
+      atoms[j] = atoms[i];
+      weights[j] = weights[i];
+      j++;
+    }
+
+  /* Literals having zero weight do not contribute at all */
+
+  for(i=0, cnt=j, j=0; i<cnt; i++)
+    if(weights[i]) {
+      atoms[j] = atoms[i];
+      weights[j] = weights[i];
+      j++;
+    } else
+      stats->literals++;
+
+  return j;
+}
+
+int remove_atoms(int cnt, int *atoms, int cnt2, int *atoms2,
+		 NORMSTATS *stats)
+{
+  int i = 0, j = 0, k = 0;
+
+  /* Both lists are sorted: delete atoms2 from atoms */
+
+  for(i=0; i<cnt; i++) {
+    while(k<cnt2 && atoms2[k] < atoms[i]) k++;
+
+    if(k<cnt2 && atoms2[k] == atoms[i])
+      stats->literals++;
+    else
+      atoms[j++] = atoms[i];
+  }
+
+  return j;
+}
+
+int intersects(int cnt1, int *atoms1, int cnt2, int *atoms2)
+{
+  int i = 0, j = 0;
+
+  /* Both lists are sorted */
+
+  while(i<cnt1 && j<cnt2)
+    if(atoms1[i] < atoms2[j])
+      i++;
+    else if(atoms1[i] > atoms2[j])
+      j++;
+    else
+      return -1;
+
+  return 0;
+}
+
+int weight_sum(int cnt, int *weights)
+{
+  int sum = 0;
+  int i = 0;
+
+  for(i=0; i<cnt; i++)
+    sum += weights[i];
+
+  return sum;
+}
+
+/* ------------------------ Normalization of rules ------------------------- */
+
+int normalize_basic(RULE *rule, NORMSTATS *stats)
+{
+  BASIC_RULE *basic = rule->data.basic;
+
+  basic->pos_cnt = unique_atom_list(basic->pos_cnt, basic->pos, stats);
+  basic->neg_cnt = unique_atom_list(basic->neg_cnt, basic->neg, stats);
+
+  if(intersects(1, &basic->head, basic->pos_cnt, basic->pos))
+    return DROP_TAUTOLOGY;
+
+  if(intersects(basic->pos_cnt, basic->pos, basic->neg_cnt, basic->neg))
+    return DROP_INAPPLICABLE;
+
+  return KEEP_RULE;
+}
+
+int normalize_constraint(RULE *rule)
+{
+  CONSTRAINT_RULE *constraint = rule->data.constraint;
+
+  /* Duplicates are counted separately and cannot be removed */
+
+  sort_atom_list(constraint->pos_cnt, constraint->pos);
+  sort_atom_list(constraint->neg_cnt, constraint->neg);
+
+  if(constraint->bound > constraint->pos_cnt + constraint->neg_cnt)
+    return DROP_INAPPLICABLE;
+
+  return KEEP_RULE;
+}
+
+int normalize_choice(RULE *rule, NORMSTATS *stats)
+{
+  CHOICE_RULE *choice = rule->data.choice;
+
+  choice->head_cnt = unique_atom_list(choice->head_cnt, choice->head, stats);
+  choice->pos_cnt = unique_atom_list(choice->pos_cnt, choice->pos, stats);
+  choice->neg_cnt = unique_atom_list(choice->neg_cnt, choice->neg, stats);
+
+  if(intersects(choice->pos_cnt, choice->pos, choice->neg_cnt, choice->neg))
+    return DROP_INAPPLICABLE;
+
+  /* Head atoms appearing positively in the body cannot be supported */
+
+  choice->head_cnt = remove_atoms(choice->head_cnt, choice->head,
+				  choice->pos_cnt, choice->pos, stats);
+
+  if(choice->head_cnt == 0)
+    return DROP_TAUTOLOGY;
+
+  return KEEP_RULE;
+}
+
+int normalize_integrity(RULE *rule, NORMSTATS *stats)
+{
+  INTEGRITY_RULE *integrity = rule->data.integrity;
+
+  integrity->pos_cnt =
+    unique_atom_list(integrity->pos_cnt, integrity->pos, stats);
+  integrity->neg_cnt =
+    unique_atom_list(integrity->neg_cnt, integrity->neg, stats);
+
+  if(intersects(integrity->pos_cnt, integrity->pos,
+		integrity->neg_cnt, integrity->neg))
+    return DROP_INAPPLICABLE;
+
+  return KEEP_RULE;
+}
+
+int normalize_weight(RULE *rule, NORMSTATS *stats)
+{
+  WEIGHT_RULE *weight = rule->data.weight;
+  int neg_cnt = weight->neg_cnt;
+  int *weights = weight->weight;
+
+  /* Weights of negative literals precede those of positive ones */
+
+  weight->neg_cnt =
+    merge_weighted_list(neg_cnt, weight->neg, weights, stats);
+  weight->pos_cnt =
+    merge_weighted_list(weight->pos_cnt, weight->pos,
+			&weights[neg_cnt], stats);
+  if(weight->neg_cnt < neg_cnt)
+    memmove(&weights[weight->neg_cnt], &weights[neg_cnt],
+	    weight->pos_cnt*sizeof(int));
+
+  if(weight->bound > weight_sum(weight->pos_cnt+weight->neg_cnt, weights))
+    return DROP_INAPPLICABLE;
+
+  return KEEP_RULE;
+}
+
+int normalize_optimize(RULE *rule, NORMSTATS *stats)
+{
+  OPTIMIZE_RULE *optimize = rule->data.optimize;
+  int neg_cnt = optimize->neg_cnt;
+  int *weights = optimize->weight;
+
+  /* Empty statements are kept since they determine priorities */
+
+  optimize->neg_cnt =
+    merge_weighted_list(neg_cnt, optimize->neg, weights, stats);
+  optimize->pos_cnt =
+    merge_weighted_list(optimize->pos_cnt, optimize->pos,
+			&weights[neg_cnt], stats);
+  if(optimize->neg_cnt < neg_cnt)
+    memmove(&weights[optimize->neg_cnt], &weights[neg_cnt],
+	    optimize->pos_cnt*sizeof(int));
+
+  return KEEP_RULE;
+}
+
+int normalize_disjunctive(RULE *rule, NORMSTATS *stats)
+{
+  DISJUNCTIVE_RULE *disjunctive = rule->data.disjunctive;
+
+  disjunctive->head_cnt =
+    unique_atom_list(disjunctive->head_cnt, disjunctive->head, stats);
+  disjunctive->pos_cnt =
+    unique_atom_list(disjunctive->pos_cnt, disjunctive->pos, stats);
+  disjunctive->neg_cnt =
+    unique_atom_list(disjunctive->neg_cnt, disjunctive->neg, stats);
+
+  if(intersects(disjunctive->head_cnt, disjunctive->head,
+		disjunctive->pos_cnt, disjunctive->pos))
+    return DROP_TAUTOLOGY;
+
+  if(intersects(disjunctive->pos_cnt, disjunctive->pos,
+		disjunctive->neg_cnt, disjunctive->neg))
+    return DROP_INAPPLICABLE;
+
+  return KEEP_RULE;
+}
+
+int normalize_rule(RULE *rule, NORMSTATS *stats)
+{
+  switch(rule->type) {
+  case TYPE_BASIC:
+    return normalize_basic(rule, stats);
+
+  case TYPE_CONSTRAINT:
+    return normalize_constraint(rule);
+
+  case TYPE_CHOICE:
+    return normalize_choice(rule, stats);
+
+  case TYPE_INTEGRITY:
+    return normalize_integrity(rule, stats);
+
+  case TYPE_WEIGHT:
+    return normalize_weight(rule, stats);
+
+  case TYPE_OPTIMIZE:
+    return normalize_optimize(rule, stats);
+
+  case TYPE_DISJUNCTIVE:
+    return normalize_disjunctive(rule, stats);
+
+  default:
+    error("unknown rule type");
+  }
+
+  return KEEP_RULE;
+}
+
+RULE *normalize_program(RULE *program, NORMSTATS *stats)
+{
+  RULE *rule = program;
+  RULE *last = NULL;       /* Last rule kept */
+  RULE *dropped = NULL;    /* Rules to be disposed of */
+
+  while(rule) {
+    RULE *next = rule->next;
+    int result = normalize_rule(rule, stats);
+
+    stats->rules++;
+
+    if(result == KEEP_RULE) {
+      if(last)
+	last->next = rule;
+      else
+	program = rule;
+      last = rule;
+    } else {
+      if(result == DROP_TAUTOLOGY)
+	stats->tautologies++;
+      else
+	stats->inapplicable++;
+
+      rule->next = dropped;
+      dropped = rule;
+    }
+
+    rule = next;
+  }
+
+  if(last)
+    last->next = NULL;
+  else
+    program = NULL;
+
+  if(dropped)
+    free_program(dropped);
+
+  return program;
+}
+
+void write_normalization_stats(FILE *out, NORMSTATS *stats)
+{
+  fprintf(out, "%s: normalized %i rules: ", program_name, stats->rules);
+  fprintf(out, "%i literals removed, %i weights merged, ",
+	  stats->literals, stats->merged);
+  fprintf(out, "%i tautologies and %i inapplicable rules dropped\n",
+	  stats->tautologies, stats->inapplicable);
+
+  return;
+}
@@ -0,0 +1,55 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Normalization of rules (sorting and merging of literals)
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+/* Version information */
+
+#define _NORMALIZE_H_RCSFILE  "$RCSfile: normalize.h,v $"
+#define _NORMALIZE_H_DATE     "$Date: 2026/10/18 10:00:00 $"
+#define _NORMALIZE_H_REVISION "$Revision: 1.1 $"
+
+extern void _version_normalize_c();
+
+/* Statistics on normalization */
+
+typedef struct normstats {
+  int rules;            /* Number of rules processed */
+  int literals;         /* Number of redundant literals removed */
+  int merged;           /* Number of weighted literals merged */
+  int tautologies;      /* Number of trivially satisfied rules removed */
+  int inapplicable;     /* Number of rules with contradictory bodies */
+} NORMSTATS;
+
+/* Results of normalize_rule() */
+
+#define KEEP_RULE 0
+#define DROP_TAUTOLOGY 1
+#define DROP_INAPPLICABLE 2
+
+/* Utilities */
+
+extern void sort_atom_list(int cnt, int *atoms);
+extern int normalize_rule(RULE *rule, NORMSTATS *stats);
+extern RULE *normalize_program(RULE *program, NORMSTATS *stats);
+extern void write_normalization_stats(FILE *out, NORMSTATS *stats);
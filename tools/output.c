@@ -0,0 +1,87 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Buffered output of strings and integers (planar, lpgen)
+ *
+ * (c) 2026 Tomi Janhunen
+ *
+ * The generators write large numbers of short tokens, for which stdio
+ * calls per token would dominate the running time.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "output.h"
+
+void set_output(OUTPUT *out, FILE *file, char *name)
+{
+  out->file = file;
+  out->name = name;
+  out->len = 0;
+
+  return;
+}
+
+void flush_output(OUTPUT *out)
+{
+  if(out->len && fwrite(out->buf, 1, out->len, out->file) != out->len) {
+    perror(out->name);
+    exit(-1);
+  }
+  out->len = 0;
+
+  return;
+}
+
+void put_string(OUTPUT *out, char *s)
+{
+  while(*s) {
+    if(out->len == OUTPUT_SIZE)
+      flush_output(out);
+    out->buf[out->len++] = *s++;
+  }
+
+  return;
+}
+
+void put_int(OUTPUT *out, long i)
+{
+  char digits[24];
+  int d = 0;
+
+  if(out->len > OUTPUT_SIZE - 24)
+    flush_output(out);
+
+  if(i < 0) {
+    out->buf[out->len++] = '-';
+    i = -i;
+  }
+
+  do {
+    digits[d++] = '0' + i % 10;
+    i /= 10;
+  } while(i);
+
+  while(d)
+    out->buf[out->len++] = digits[--d];
+
+  return;
+}
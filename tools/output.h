@@ -0,0 +1,44 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Buffered output of strings and integers (planar, lpgen)
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+/* Version information */
+
+#define _OUTPUT_H_RCSFILE  "$RCSfile: output.h,v $"
+#define _OUTPUT_H_DATE     "$Date: 2026/10/18 23:00:00 $"
+#define _OUTPUT_H_REVISION "$Revision: 1.1 $"
+
+#define OUTPUT_SIZE (1<<16)
+
+typedef struct output {
+  FILE *file;
+  char *name;           /* Reported on write errors */
+  int len;
+  char buf[OUTPUT_SIZE];
+} OUTPUT;
+
+extern void set_output(OUTPUT *out, FILE *file, char *name);
+extern void flush_output(OUTPUT *out);
+extern void put_string(OUTPUT *out, char *s);
+extern void put_int(OUTPUT *out, long i);
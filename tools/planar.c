@@ -23,6 +23,9 @@
  * (c) 2002 Tomi Janhunen
  *
  * Driver program
+ *
+ * (c) 2026 Tomi Janhunen: iterative traversal, buffered output, and
+ *                         ground programs in SMODELS format
  */
 
 /*
@@ -30,60 +33,604 @@
  *       (Package sgb in the Debian Linux distribution)!
  */
 
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
 #include <gb_graph.h>
 #include <gb_plane.h>
 #include <gb_save.h>
 
-void print_vertex(Vertex *v)
+#include "output.h"
+
+/* ------------------------- Traversing the graph ------------------------- */
+
+/* Depth-first traversal from the first vertex using an explicit stack
+   of arc cursors; vertices are listed in the order reached, and the
+   facts are the arcs of each vertex in this order (the same order as
+   a recursive traversal printing the arcs of a vertex when reaching it) */
+
+long *visit_order(Graph *g, long *ids, long *cnt)
 {
-  Arc *a = v->arcs;
+  Vertex *base = g->vertices;
+  long n = g->n;
+  long *order = (long *)malloc(n*sizeof(long));
+  Arc **stack = (Arc **)malloc((n+1)*sizeof(Arc *));
+  long top = 0;
 
-  v->u.I = atoi(v->name);
+  if(!order || !stack) {
+    fprintf(stderr, "planar: cannot allocate memory for %li vertices!\n", n);
+    exit(-1);
+  }
 
-  while(a) {
-    Vertex *v2 = a->tip;
-    printf("arc(%s,%s).\n", v->name, v2->name);
-    a = a->next;
+  *cnt = 0;
+  base->u.I = ids[0];
+  order[(*cnt)++] = 0;
+  stack[top++] = base->arcs;
+
+  while(top) {
+    Arc *a = stack[top-1];
+    Vertex *v2 = NULL;
+
+    if(!a) {
+      top--;
+      continue;
+    }
+
+    stack[top-1] = a->next;
+    v2 = a->tip;
+
+    if(v2->u.I != ids[v2-base]) {
+      v2->u.I = ids[v2-base];
+      order[(*cnt)++] = v2-base;
+      stack[top++] = v2->arcs;
+    }
   }
 
-  a = v->arcs;
+  free(stack);
 
-  while(a) {
-    Vertex *v2 = a->tip;
-    if(v2->u.I != atoi(v2->name))
-      print_vertex(v2);
-    a = a->next;
+  return order;
+}
+
+/* ------------------------- Printing facts ------------------------------- */
+
+void print_facts(OUTPUT *out, int n, Graph *g, long *ids,
+		 long *order, long cnt)
+{
+  Vertex *base = g->vertices;
+  long j = 0;
+
+  for(j=0; j<n; j++) {
+    put_string(out, "vertex(");
+    put_int(out, j);
+    put_string(out, ").\n");
+  }
+
+  for(j=0; j<cnt; j++) {
+    Vertex *v = &base[order[j]];
+    Arc *a = NULL;
+
+    for(a = v->arcs; a; a = a->next) {
+      put_string(out, "arc(");
+      put_int(out, ids[v-base]);
+      put_string(out, ",");
+      put_int(out, ids[a->tip-base]);
+      put_string(out, ").\n");
+    }
   }
 
   return;
 }
 
+/* ------------------------- Printing a ground program -------------------- */
+
+/* Atom numbers: the false atom 1 (only for colouring), vertex/1 facts,
+   colour/2 atoms for each vertex and colour, and arc/2 facts in the
+   order of printing; parallel arcs share names and are taken once */
+
+void reset_seen(long *seen, long n)
+{
+  long j = 0;
+
+  for(j=0; j<n; j++)
+    seen[j] = -1;
+
+  return;
+}
+
+int new_arc(Arc *a, long v, long *seen, Vertex *base)
+{
+  if(seen[a->tip-base] == v)
+    return 0;
+
+  seen[a->tip-base] = v;
+
+  return -1;
+}
+
+void put_rule_start(OUTPUT *out, int type, long head)
+{
+  put_int(out, type);
+  put_string(out, " ");
+  put_int(out, head);
+
+  return;
+}
+
+void put_atoms(OUTPUT *out, long first, int cnt)
+{
+  int i = 0;
+
+  for(i=0; i<cnt; i++) {
+    put_string(out, " ");
+    put_int(out, first+i);
+  }
+
+  return;
+}
+
+void print_smodels(OUTPUT *out, int n, int k, Graph *g, long *ids,
+		   long *order, long cnt)
+{
+  Vertex *base = g->vertices;
+  long first = k ? 2 : 1;               /* Atom for vertex(0) */
+  long colour = first + n;              /* Atom for colour(v0,1) */
+  long arc = colour + g->n*k;           /* Atom for the first arc */
+  long next = arc;
+  long *seen = (long *)malloc(g->n*sizeof(long));
+  long j = 0;
+  int c = 0;
+
+  if(!seen) {
+    fprintf(stderr, "planar: cannot allocate memory for %li vertices!\n",
+	    g->n);
+    exit(-1);
+  }
+
+  /* Facts */
+
+  for(j=0; j<n; j++) {
+    put_rule_start(out, 1, first+j);
+    put_string(out, " 0 0\n");
+  }
+
+  reset_seen(seen, g->n);
+
+  for(j=0; j<cnt; j++) {
+    Arc *a = NULL;
+
+    for(a = base[order[j]].arcs; a; a = a->next)
+      if(new_arc(a, order[j], seen, base)) {
+	put_rule_start(out, 1, next++);
+	put_string(out, " 0 0\n");
+      }
+  }
+
+  /* Each vertex gets exactly one of k colours, and the endpoints of an
+     edge differ in colour; each edge is covered once, from the end point
+     with a smaller identifier */
+
+  if(k) {
+    for(j=0; j<g->n; j++) {
+      long atoms = colour + j*k;
+
+      put_rule_start(out, 3, k);
+      put_atoms(out, atoms, k);
+      put_string(out, " 0 0\n");
+
+      put_rule_start(out, 1, 1);
+      put_string(out, " ");
+      put_int(out, k);
+      put_string(out, " ");
+      put_int(out, k);
+      put_atoms(out, atoms, k);
+      put_string(out, "\n");
+
+      if(k > 1) {
+	put_rule_start(out, 2, 1);
+	put_string(out, " ");
+	put_int(out, k);
+	put_string(out, " 0 2");
+	put_atoms(out, atoms, k);
+	put_string(out, "\n");
+      }
+    }
+
+    reset_seen(seen, g->n);
+
+    for(j=0; j<cnt; j++) {
+      Vertex *v = &base[order[j]];
+      Arc *a = NULL;
+
+      for(a = v->arcs; a; a = a->next) {
+	if(ids[v-base] >= ids[a->tip-base] || !new_arc(a, order[j], seen, base))
+	  continue;
+
+	for(c=0; c<k; c++) {
+	  put_rule_start(out, 1, 1);
+	  put_string(out, " 2 0 ");
+	  put_int(out, colour + (v-base)*k + c);
+	  put_string(out, " ");
+	  put_int(out, colour + (a->tip-base)*k + c);
+	  put_string(out, "\n");
+	}
+      }
+    }
+  }
+
+  put_string(out, "0\n");
+
+  /* Symbol table */
+
+  for(j=0; j<n; j++) {
+    put_int(out, first+j);
+    put_string(out, " vertex(");
+    put_int(out, j);
+    put_string(out, ")\n");
+  }
+
+  for(j=0; j<g->n; j++)
+    for(c=1; c<=k; c++) {
+      put_int(out, colour + j*k + c-1);
+      put_string(out, " colour(");
+      put_int(out, ids[j]);
+      put_string(out, ",");
+      put_int(out, c);
+      put_string(out, ")\n");
+    }
+
+  next = arc;
+  reset_seen(seen, g->n);
+
+  for(j=0; j<cnt; j++) {
+    Vertex *v = &base[order[j]];
+    Arc *a = NULL;
+
+    for(a = v->arcs; a; a = a->next) {
+      if(!new_arc(a, order[j], seen, base))
+	continue;
+      put_int(out, next++);
+      put_string(out, " arc(");
+      put_int(out, ids[v-base]);
+      put_string(out, ",");
+      put_int(out, ids[a->tip-base]);
+      put_string(out, ")\n");
+    }
+  }
+
+  put_string(out, "0\nB+\n0\nB-\n");
+  if(k)
+    put_string(out, "1\n");
+  put_string(out, "0\n1\n");
+
+  free(seen);
+
+  return;
+}
+
+/* ------------------------- Generating instances ------------------------ */
+
+OUTPUT output;
+
+int generate(FILE *file, int n, int s, int smodels, int colours)
+{
+  OUTPUT *out = &output;
+  Graph *g = plane(n, 0, 0, 0, 0, s);
+  long *ids = NULL;
+  long *order = NULL;
+  long cnt = 0;
+  long j = 0;
+
+  if(!g)
+    return -1;
+
+  ids = (long *)malloc(g->n*sizeof(long));
+
+  if(!ids) {
+    fprintf(stderr, "planar: cannot allocate memory for %li vertices!\n",
+	    g->n);
+    exit(-1);
+  }
+
+  for(j=0; j<g->n; j++)
+    ids[j] = atol(g->vertices[j].name);
+
+  order = visit_order(g, ids, &cnt);
+
+  set_output(out, file, "planar");
+
+  if(smodels)
+    print_smodels(out, n, colours, g, ids, order, cnt);
+  else
+    print_facts(out, n, g, ids, order, cnt);
+  flush_output(out);
+
+  free(order);
+  free(ids);
+  gb_recycle(g);
+
+  return 0;
+}
+
+/* ------------------------- Batch mode ----------------------------------- */
+
+/*
+ * Instances for all combinations of sizes and seeds are generated by
+ * worker processes which take the numbers of jobs from a shared pipe.
+ * Processes rather than threads are used, since the random number
+ * generator and memory areas of Stanford Graph Base are global; as
+ * plane() initializes the generator from the seed, each file is the
+ * same as produced by a single run.
+ */
+
+/* Parse lists like 1000,2000 or 1-100,200 */
+
+int *parse_list(char *name, char *arg, int *cnt)
+{
+  int size = 16;
+  int *list = (int *)malloc(size*sizeof(int));
+  char *p = arg;
+
+  *cnt = 0;
+
+  while(*p) {
+    char *end = NULL;
+    long first = strtol(p, &end, 10);
+    long last = first;
+
+    if(end == p) {
+      fprintf(stderr, "%s: invalid list %s\n", name, arg);
+      exit(-1);
+    }
+
+    p = end;
+
+    if(*p == '-') {
+      last = strtol(++p, &end, 10);
+      if(end == p || last < first) {
+	fprintf(stderr, "%s: invalid range in %s\n", name, arg);
+	exit(-1);
+      }
+      p = end;
+    }
+
+    for(; first <= last; first++) {
+      if(*cnt == size) {
+	size *= 2;
+	list = (int *)realloc(list, size*sizeof(int));
+      }
+      list[(*cnt)++] = first;
+    }
+
+    if(*p == ',')
+      p++;
+    else if(*p) {
+      fprintf(stderr, "%s: invalid list %s\n", name, arg);
+      exit(-1);
+    }
+  }
+
+  return list;
+}
+
+int generate_file(char *name, char *dir, int n, int s,
+		  int smodels, int colours)
+{
+  char *file = (char *)malloc(strlen(dir)+64);
+  FILE *out = NULL;
+  int status = 0;
+
+  sprintf(file, "%s/planar-%i-%i.%s", dir, n, s, smodels ? "sm" : "lp");
+
+  if((out = fopen(file, "w")) == NULL) {
+    fprintf(stderr, "%s: cannot create file %s\n", name, file);
+    free(file);
+    return -1;
+  }
+
+  if(generate(out, n, s, smodels, colours)) {
+    fprintf(stderr, "%s: cannot generate %s (panic code %li)\n",
+	    name, file, panic_code);
+    status = -1;
+  }
+
+  fclose(out);
+  free(file);
+
+  return status;
+}
+
+void batch_generate(char *name, char *dir, int workers,
+		    int size_cnt, int *sizes, int seed_cnt, int *seeds,
+		    int smodels, int colours)
+{
+  int cnt = size_cnt*seed_cnt;
+  int jobs[2];
+  int failed = 0;
+  int undispatched = 0;
+  void (*pipe_handler)(int) = NULL;
+  int i = 0;
+
+  if(pipe(jobs)) {
+    fprintf(stderr, "%s: cannot create a pipe\n", name);
+    exit(-1);
+  }
+
+  fflush(NULL);
+
+  for(i=0; i<workers; i++) {
+    pid_t pid = fork();
+
+    if(pid < 0) {
+      fprintf(stderr, "%s: cannot create a worker process\n", name);
+      exit(-1);
+    }
+
+    if(pid == 0) {
+      int job = 0;
+      int status = 0;
+
+      close(jobs[1]);
+
+      while(read(jobs[0], &job, sizeof(int)) == sizeof(int))
+	if(generate_file(name, dir, sizes[job/seed_cnt], seeds[job%seed_cnt],
+			 smodels, colours))
+	  status = -1;
+
+      exit(status);
+    }
+  }
+
+  close(jobs[0]);
+
+  /* If all workers have died, writing fails with EPIPE (not SIGPIPE)
+     so that the failures can still be collected and reported */
+
+  pipe_handler = signal(SIGPIPE, SIG_IGN);
+
+  for(i=0; i<cnt; i++)
+    if(write(jobs[1], &i, sizeof(int)) != sizeof(int)) {
+      fprintf(stderr, "%s: cannot dispatch jobs\n", name);
+      undispatched = cnt-i;
+      break;
+    }
+
+  close(jobs[1]);
+  signal(SIGPIPE, pipe_handler);
+
+  for(i=0; i<workers; i++) {
+    int status = 0;
+
+    wait(&status);
+    if(!WIFEXITED(status) || WEXITSTATUS(status))
+      failed++;
+  }
+
+  if(failed) {
+    fprintf(stderr, "%s: %i out of %i workers failed\n",
+	    name, failed, workers);
+    exit(-1);
+  }
+
+  if(undispatched) {
+    fprintf(stderr, "%s: %i out of %i instances not dispatched\n",
+	    name, undispatched, cnt);
+    exit(-1);
+  }
+
+  return;
+}
+
+/* ------------------------- Main program --------------------------------- */
+
+void usage(char *name)
+{
+  fprintf(stderr, "\nusage:");
+  fprintf(stderr, "   %s <options> <number of vertices> <seed>\n\n", name);
+  fprintf(stderr, "options:\n");
+  fprintf(stderr, "   -h or --help -- print help message\n");
+  fprintf(stderr, "   -s -- output a ground program in SMODELS format\n");
+  fprintf(stderr, "   -k=<number>\n");
+  fprintf(stderr, "      -- add a ground encoding of graph colouring\n");
+  fprintf(stderr, "         with the given number of colours (implies -s)\n");
+  fprintf(stderr, "   -b -- batch mode: the number of vertices and the seed\n");
+  fprintf(stderr, "         are lists like 1000,5000 and 1-100, and each\n");
+  fprintf(stderr, "         instance goes to planar-<vertices>-<seed>.lp\n");
+  fprintf(stderr, "         (or .sm in SMODELS format)\n");
+  fprintf(stderr, "   -w=<number>\n");
+  fprintf(stderr, "      -- generate a batch using worker processes\n");
+  fprintf(stderr, "   -d=<directory>\n");
+  fprintf(stderr, "      -- write the files of a batch to the directory\n");
+  fprintf(stderr, "\n");
+
+  return;
+}
+
 int main(int argc, char **argv)
 {
-  Graph *g = NULL;
   int n = 0;
   int s = 0;
+  int option_smodels = 0;
+  int option_batch = 0;
+  int colours = 0;
+  int workers = 1;
+  char *dir = ".";
+  char *args[2];
+  int pcnt = 0;
+  int i = 0;
+
+  for(i=1; i<argc; i++) {
+    char *arg = argv[i];
+
+    if(strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+      usage(argv[0]);
+      exit(0);
+    } else if(strcmp(arg, "-s") == 0)
+      option_smodels = -1;
+    else if(strcmp(arg, "-b") == 0)
+      option_batch = -1;
+    else if(strncmp(arg, "-k=", 3) == 0) {
+      colours = atoi(&arg[3]);
+      option_smodels = -1;
+      if(colours < 1) {
+	fprintf(stderr, "%s: the number of colours must be positive!\n",
+		argv[0]);
+	exit(-1);
+      }
+    } else if(strncmp(arg, "-w=", 3) == 0) {
+      workers = atoi(&arg[3]);
+      if(workers < 1) {
+	fprintf(stderr, "%s: the number of workers must be positive!\n",
+		argv[0]);
+	exit(-1);
+      }
+    } else if(strncmp(arg, "-d=", 3) == 0)
+      dir = &arg[3];
+    else if(arg[0] == '-' && !(arg[1] >= '0' && arg[1] <= '9')) {
+      fprintf(stderr, "%s: unknown option %s\n", argv[0], arg);
+      usage(argv[0]);
+      exit(-1);
+    } else if(pcnt < 2)
+      args[pcnt++] = arg;
+    else
+      pcnt++;
+  }
+
+  if(pcnt != 2) {
+    usage(argv[0]);
+    exit(-1);
+  }
+
+  if(option_batch) {
+    int size_cnt = 0, seed_cnt = 0;
+    int *sizes = parse_list(argv[0], args[0], &size_cnt);
+    int *seeds = parse_list(argv[0], args[1], &seed_cnt);
 
-  if(argc == 3) {
-    n = atoi(argv[1]);
-    s = atoi(argv[2]);
+    for(i=0; i<size_cnt; i++)
+      if(sizes[i]<2) {
+	fprintf(stderr, "%s: the number of vertices must exceed 2!\n",
+		argv[0]);
+	exit(-1);
+      }
+
+    batch_generate(argv[0], dir, workers, size_cnt, sizes, seed_cnt, seeds,
+		   option_smodels, colours);
+
+    free(sizes);
+    free(seeds);
+  } else {
+    n = atoi(args[0]);
+    s = atoi(args[1]);
     if(n<2) {
        fprintf(stderr, "%s: the number of vertices must exceed 2!\n", argv[0]);
       exit(-1);
     }
-    g = plane(n, 0, 0, 0, 0, s);    
-    
-    if(g) {
-      int j = 0;
-      for(j=0; j<n; j++)
-	printf("vertex(%i).\n", j);
-      print_vertex(g->vertices);
-    }
-
-    exit(0);
-  } else {
-    fprintf(stderr, "usage: %s: <number of vertices> <seed>\n", argv[0]);
-    exit(-1);
+    generate(stdout, n, s, option_smodels, colours);
   }
-}
 
+  exit(0);
+}
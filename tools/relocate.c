@@ -311,3 +311,110 @@ void reloc_program(RULE *rule, ATAB *table)
   }
   return;
 }
+
+/* -------------- Compact the atoms of a complete program ---------------- */
+
+ATAB *mark_used_atoms(RULE *program, ATAB *table)
+{
+  int i = 0;
+
+  /* Atoms still occurring in rules or being visible are used */
+
+  if(table->next)
+    table = make_contiguous(table);
+
+  for(i=1; i<=table->count; i++)
+    table->statuses[i] &= ~(MARK_POSOCC_OR_NEGOCC | MARK_HEADOCC);
+
+  mark_visible(table);
+  mark_occurrences(program, table);
+
+  if(table->others)
+    free(table->others);
+  table->others = (int *)calloc(table->count+1, sizeof(int));
+
+  return table;
+}
+
+ATAB *compact_program(RULE *program, ATAB *table)
+{
+  int shift = 0;
+  int size = 0;
+
+  /* Atoms no longer occurring in rules are removed unless visible;
+     the remaining atoms are renumbered starting from the offset */
+
+  if(!table)
+    return table;
+
+  table = mark_used_atoms(program, table);
+  shift = table->offset;
+
+  size = reloc_symbol_table(table, shift) - shift;
+  reloc_program(program, table);
+
+  table = compress_symbol_table(table, size, shift);
+  attach_atoms_to_names(table);
+
+  return table;
+}
+
+/* ---------------- Renumber atoms in a given order ----------------------- */
+
+ATAB *reorder_program(RULE *program, ATAB *table, int cnt, int *order)
+{
+  ATAB *new = NULL;
+  int shift = 0;
+  int offset = 0;
+  int size = 0;
+  int i = 0;
+
+  /* Used atoms are numbered in the order given (others stay last) */
+
+  if(!table)
+    return table;
+
+  table = mark_used_atoms(program, table);
+  shift = offset = table->offset;
+
+  for(i=0; i<cnt; i++) {
+    int j = order[i]-offset;
+    int status = table->statuses[j];
+
+    if(!table->others[j] &&
+       (status & (MARK_POSOCC_OR_NEGOCC | MARK_HEADOCC | MARK_VISIBLE)))
+      table->others[j] = shift + (++size);
+  }
+
+  for(i=1; i<=table->count; i++) {
+    int status = table->statuses[i];
+
+    if(!table->others[i] &&
+       (status & (MARK_POSOCC_OR_NEGOCC | MARK_HEADOCC | MARK_VISIBLE)))
+      table->others[i] = shift + (++size);
+  }
+
+  reloc_program(program, table);
+
+  /* Permute the contents of the table */
+
+  new = new_table(size, shift);
+
+  for(i=1; i<=table->count; i++) {
+    int other = table->others[i];
+
+    if(other) {
+      new->names[other-shift] = table->names[i];
+      new->statuses[other-shift] = table->statuses[i];
+    }
+  }
+
+  free(table->names);
+  free(table->statuses);
+  free(table->others);
+  free(table);
+
+  attach_atoms_to_names(new);
+
+  return new;
+}
@@ -35,5 +35,8 @@ extern void _version_relocate_c();
 
 extern int reloc_symbol_table(ATAB *table, int shift);
 extern ATAB *compress_symbol_table(ATAB *table, int size, int shift);
+extern void reloc_rule(RULE *rule, ATAB *table);
 extern void reloc_program(RULE *program, ATAB *table);
+extern ATAB *compact_program(RULE *program, ATAB *table);
+extern ATAB *reorder_program(RULE *program, ATAB *table, int cnt, int *order);
 
@@ -0,0 +1,175 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Renumbering of atoms so that atoms depending on each other obtain
+ * nearby numbers; the order of the symbol table already clusters atoms
+ * by the modules where they first appear
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "version.h"
+#include "symbol.h"
+#include "atom.h"
+#include "rule.h"
+#include "io.h"
+#include "scc.h"
+#include "relocate.h"
+#include "renumber.h"
+
+void _version_renumber_h()
+{
+  _version(_RENUMBER_H_RCSFILE, _RENUMBER_H_DATE, _RENUMBER_H_REVISION);
+}
+
+void _version_renumber_c()
+{
+  _version_renumber_h();
+  _version("$RCSfile: renumber.c,v $",
+	   "$Date: 2026/10/18 16:00:00 $",
+	   "$Revision: 1.1 $");
+}
+
+int parse_order(char *name)
+{
+  if(strcmp(name, "scc") == 0)
+    return ORDER_SCC;
+  else if(strcmp(name, "bfs") == 0)
+    return ORDER_BFS;
+  else if(strcmp(name, "none") == 0 || strcmp(name, "module") == 0)
+    return ORDER_NONE;
+
+  return -1;
+}
+
+/* ------------- Breadth-first order (dependencies undirected) ------------- */
+
+void enqueue_atom(int atom, int *seen, int *order, int *cnt)
+{
+  if(!seen[atom]) {
+    seen[atom] = -1;
+    order[(*cnt)++] = atom;
+  }
+
+  return;
+}
+
+void enqueue_rule(RULE *rule, int *seen, int *order, int *cnt)
+{
+  int *atoms = NULL;
+  int i = 0;
+
+  if(rule->type != TYPE_OPTIMIZE && rule->type != TYPE_INTEGRITY) {
+    atoms = get_heads(rule);
+    for(i=0; i<get_head_cnt(rule); i++)
+      enqueue_atom(atoms[i], seen, order, cnt);
+  }
+
+  atoms = get_pos(rule);
+  for(i=0; i<get_pos_cnt(rule); i++)
+    enqueue_atom(atoms[i], seen, order, cnt);
+
+  atoms = get_neg(rule);
+  for(i=0; i<get_neg_cnt(rule); i++)
+    enqueue_atom(atoms[i], seen, order, cnt);
+
+  return;
+}
+
+int compute_bfs_order(RULE *program, OCCTAB *occtab, int max_atom,
+		      int *order)
+{
+  int rule_cnt = compute_body_occurrences(program, occtab);
+  RULE **rules = (RULE **)malloc((rule_cnt+1)*sizeof(RULE *));
+  int *seen = (int *)calloc(max_atom+1, sizeof(int));
+  RULE *rule = NULL;
+  OCCTAB *scan = occtab;
+  int cnt = 0;           /* End of the queue */
+  int first = 0;         /* Beginning of the queue */
+  int i = 0;
+
+  for(rule = program; rule; rule = rule->next)
+    rules[i++] = rule;
+
+  /* The queue is kept in the order itself */
+
+  while(scan) {
+    int count = scan->count;
+    int offset = scan->offset;
+
+    for(i=1; i<=count; i++) {
+      enqueue_atom(i+offset, seen, order, &cnt);
+
+      while(first < cnt) {
+	OCCURRENCES *h = find_occurrences(occtab, order[first++]);
+	int j = 0;
+
+	for(j=0; j<h->rule_cnt; j++)
+	  enqueue_rule(h->rules[j], seen, order, &cnt);
+	for(j=0; j<h->pos_cnt; j++)
+	  enqueue_rule(rules[(h->posbody)[j].rule], seen, order, &cnt);
+	for(j=0; j<h->neg_cnt; j++)
+	  enqueue_rule(rules[(h->negbody)[j].rule], seen, order, &cnt);
+      }
+    }
+
+    scan = scan->next;
+  }
+
+  free(rules);
+  free(seen);
+
+  return cnt;
+}
+
+/* ---------------------------- Renumbering ------------------------------- */
+
+ATAB *renumber_program(RULE *program, ATAB *table, int order)
+{
+  OCCTAB *occtab = NULL;
+  int max_atom = 0;
+  int *atoms = NULL;
+  int cnt = 0;
+
+  if(!table || order == ORDER_NONE)
+    return table;
+
+  max_atom = table_size(table);
+  atoms = (int *)malloc((max_atom+1)*sizeof(int));
+
+  occtab = initialize_occurrences(table);
+  compute_occurrences(program, occtab, 0);
+
+  if(order == ORDER_SCC)
+    cnt = compute_scc_order(occtab, max_atom, atoms);
+  else
+    cnt = compute_bfs_order(program, occtab, max_atom, atoms);
+
+  table = reorder_program(program, table, cnt, atoms);
+
+  free(atoms);
+  free_occurrences(occtab);
+
+  return table;
+}
@@ -0,0 +1,43 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Renumbering of atoms for locality
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+/* Version information */
+
+#define _RENUMBER_H_RCSFILE  "$RCSfile: renumber.h,v $"
+#define _RENUMBER_H_DATE     "$Date: 2026/10/18 16:00:00 $"
+#define _RENUMBER_H_REVISION "$Revision: 1.1 $"
+
+extern void _version_renumber_c();
+
+/* Orders */
+
+#define ORDER_NONE   0     /* Order of the symbol table (modules) */
+#define ORDER_SCC    1     /* Topological order of SCCs */
+#define ORDER_BFS    2     /* Breadth-first order over dependencies */
+
+/* Utilities */
+
+extern int parse_order(char *name);
+extern ATAB *renumber_program(RULE *program, ATAB *table, int order);
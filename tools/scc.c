@@ -84,6 +84,10 @@ OCCTAB *initialize_occurrences(ATAB *table)
 
       h->rule_cnt = 0;
       h->rules = NULL;
+      h->pos_cnt = 0;
+      h->posbody = NULL;
+      h->neg_cnt = 0;
+      h->negbody = NULL;
       h->scc = 0;
       h->scc_size = 0;
       h->visited = 0;
@@ -108,6 +112,31 @@ OCCTAB *initialize_occurrences(ATAB *table)
   return rvalue;
 }
 
+void free_occurrences(OCCTAB *occtab)
+{
+  while(occtab) {
+    OCCTAB *next = occtab->next;
+    int i = 0;
+
+    for(i=1; i<=occtab->count; i++) {
+      OCCURRENCES *h = &(occtab->ashead)[i];
+
+      if(h->rules)
+	free(h->rules);
+      if(h->posbody)
+	free(h->posbody);
+      if(h->negbody)
+	free(h->negbody);
+    }
+
+    free(occtab->ashead);
+    free(occtab);
+    occtab = next;
+  }
+
+  return;
+}
+
 OCCTAB *append_occurrences(OCCTAB *table, OCCTAB *occurrences)
 {
   OCCTAB *scan = table;
@@ -303,6 +332,99 @@ void compute_occurrences(RULE *program, OCCTAB *occtab, int prune)
   return;
 }
 
+/* ---------- Form the index of body occurrences (for propagation) --------- */
+
+void count_body_list(int cnt, int *atoms, OCCTAB *occtab, int positive)
+{
+  int i = 0;
+
+  for(i=0; i<cnt; i++) {
+    OCCURRENCES *h = find_occurrences(occtab, atoms[i]);
+
+    if(positive)
+      h->pos_cnt++;
+    else
+      h->neg_cnt++;
+  }
+
+  return;
+}
+
+void collect_body_list(int cnt, int *atoms, int number, OCCTAB *occtab,
+		       int positive)
+{
+  int i = 0;
+
+  for(i=0; i<cnt; i++) {
+    OCCURRENCES *h = find_occurrences(occtab, atoms[i]);
+    BODYOCC *b = NULL;
+
+    if(positive)
+      b = &(h->posbody)[h->pos_cnt++];
+    else
+      b = &(h->negbody)[h->neg_cnt++];
+
+    b->rule = number;
+    b->index = i;
+  }
+
+  return;
+}
+
+int compute_body_occurrences(RULE *program, OCCTAB *occtab)
+{
+  RULE *scan = program;
+  OCCTAB *pass = occtab;
+  int number = 0;
+
+  /* ------ Count body occurrences of atoms ------ */
+
+  while(scan) {
+
+    /* Minimize statements do not affect the values of atoms */
+
+    if(scan->type != TYPE_OPTIMIZE) {
+      count_body_list(get_pos_cnt(scan), get_pos(scan), occtab, -1);
+      count_body_list(get_neg_cnt(scan), get_neg(scan), occtab, 0);
+    }
+
+    scan = scan->next;
+  }
+
+  /* ------ Allocate memory for occurrences ------ */
+
+  while(pass) {
+    int count = pass->count;
+    OCCURRENCES *ashead = pass->ashead;
+    int i = 0;
+
+    for(i=1; i<=count; i++) {
+      OCCURRENCES *h = &ashead[i];
+
+      if(h->pos_cnt) {
+	h->posbody = (BODYOCC *)malloc(sizeof(BODYOCC)*(h->pos_cnt));
+	h->pos_cnt = 0;
+      }
+      if(h->neg_cnt) {
+	h->negbody = (BODYOCC *)malloc(sizeof(BODYOCC)*(h->neg_cnt));
+	h->neg_cnt = 0;
+      }
+    }
+
+    pass = pass->next;
+  }
+
+  /* ------ Collect body occurrences of atoms ------ */
+
+  for(scan = program; scan; scan = scan->next, number++)
+    if(scan->type != TYPE_OPTIMIZE) {
+      collect_body_list(get_pos_cnt(scan), get_pos(scan), number, occtab, -1);
+      collect_body_list(get_neg_cnt(scan), get_neg(scan), number, occtab, 0);
+    }
+
+  return number;
+}
+
 int count_on(ASTACK *stack, int atom)
 {
   int rvalue = 0;
@@ -460,6 +582,80 @@ void compute_sccs(OCCTAB *occtab, int max_atom, int control)
   return;
 }
 
+/* --------------- SCCs needed for a given set of atoms only ---------------- */
+
+/*
+ * compute_positive_occurrences -- Index rules by heads in a single pass,
+ * but only rules with positive bodies: other rules give no positive
+ * dependencies to follow, and atoms defined by such rules only form
+ * singleton SCCs on their own. The lists grow by doubling.
+ */
+
+void compute_positive_occurrences(RULE *program, OCCTAB *occtab)
+{
+  RULE *scan = NULL;
+  int i = 0;
+
+  for(scan = program; scan; scan = scan->next) {
+    int *heads = get_heads(scan);
+    int head_cnt = get_head_cnt(scan);
+
+    if(scan->type == TYPE_OPTIMIZE || get_pos_cnt(scan) == 0)
+      continue;
+
+    for(i=0; i<head_cnt; i++) {
+      OCCURRENCES *h = find_occurrences(occtab, heads[i]);
+      int cnt = h->rule_cnt;
+
+      if((cnt & (cnt-1)) == 0)
+	h->rules = (RULE **)realloc(h->rules, sizeof(RULE *)*(cnt ? 2*cnt : 1));
+      h->rules[h->rule_cnt++] = scan;
+    }
+  }
+
+  return;
+}
+
+/*
+ * compute_sccs_from -- Compute SCCs for the given atoms only; other atoms
+ * get SCCs only if they are reached via dependencies (scc = 0 otherwise)
+ */
+
+void compute_sccs_from(OCCTAB *occtab, int max_atom, int cnt, int *atoms,
+		       int control)
+{
+  int next = 0;           /* Next free component number */
+  ASTACK *stack = NULL;   /* Global stack to be used by visit */
+  int i = 0;
+
+  for(i=0; i<cnt; i++) {
+    OCCURRENCES *h = find_occurrences(occtab, atoms[i]);
+
+    if(h->visited == 0)
+      visit(atoms[i], &next, max_atom, &stack, occtab, control);
+  }
+
+  return;
+}
+
+/* Forget SCCs so that they can be computed again */
+
+void reset_sccs(OCCTAB *occtab)
+{
+  int i = 0;
+
+  for(; occtab; occtab = occtab->next)
+    for(i=1; i<=occtab->count; i++) {
+      OCCURRENCES *h = &(occtab->ashead)[i];
+
+      h->scc = 0;
+      h->scc_size = 0;
+      h->visited = 0;
+    }
+
+  return;
+}
+
 /* ------------- Check stratifiability of the invisible part -------------- */
 
 int in_scc(int scc, int cnt, int *first, OCCTAB *occtab)
@@ -535,11 +731,11 @@ int is_stratifiable(OCCTAB *occtab)
 /* ---- Analysis of joint positive dependencies (for module conditions) --- */
 
 int pos_visit(int atom, int *next, int max_atom,
-	      ASTACK **stack, OCCTAB *occtab);
+	      ASTACK **stack, OCCTAB *occtab, FILE *err, int *errors);
 
 void pos_visit_list(int *first, int cnt, int *next,
 		    int *min, int max_atom, ASTACK **stack,
-		    OCCTAB *occtab)
+		    OCCTAB *occtab, FILE *err, int *errors)
 {
   int i = 0;
 
@@ -549,7 +745,7 @@ void pos_visit_list(int *first, int cnt, int *next,
     int rvalue = h->visited;
 
     if(rvalue == 0)
-	rvalue = pos_visit(atom, next, max_atom, stack, occtab);
+	rvalue = pos_visit(atom, next, max_atom, stack, occtab, err, errors);
 
     if(rvalue < *min) *min = rvalue;
   }
@@ -558,7 +754,7 @@ void pos_visit_list(int *first, int cnt, int *next,
 }
 
 int pos_visit(int atom, int *next, int max_atom,
-	      ASTACK **stack, OCCTAB *occtab)
+	      ASTACK **stack, OCCTAB *occtab, FILE *err, int *errors)
 {
   OCCURRENCES *h = find_occurrences(occtab, atom);
   int min = ++(*next);
@@ -580,7 +776,8 @@ int pos_visit(int atom, int *next, int max_atom,
     first = get_pos(r);
     pos_cnt = get_pos_cnt(r);
     if(pos_cnt)
-      pos_visit_list(first, pos_cnt, next, &min, max_atom, stack, occtab);
+      pos_visit_list(first, pos_cnt, next, &min, max_atom, stack, occtab,
+		     err, errors);
   }
 
   /* Unwind a SCC from the stack */
@@ -612,20 +809,20 @@ int pos_visit(int atom, int *next, int max_atom,
       failing = push(atom2, 0, NULL, failing);
     }
 
-    if(fail) {
-      fprintf(stderr, "%s: module error: ", program_name);
-      fprintf(stderr, "positively interdependent atoms: ");
+    if(fail)
+      (*errors)++;
+
+    if(fail && *errors == 1 && err) { /* Report the first one */
+      fprintf(err, "module error: ");
+      fprintf(err, "positively interdependent atoms: ");
 
       while(failing) { /* Unwind and print */
 	failing = pop(&atom2, NULL, NULL, failing);
-	write_atom(STYLE_READABLE, stderr, atom2, occtab->atoms);
+	write_atom(STYLE_READABLE, err, atom2, occtab->atoms);
 	if(failing)
-	  fputc(' ', stderr);
+	  fputc(' ', err);
       }
-      fprintf(stderr, "!\n");
-
-      exit(-1);
-
+      fprintf(err, "!\n");
     } else { /* Unwind and forget */
       while(failing)
 	failing = pop(&atom2, NULL, NULL, failing);
@@ -635,9 +832,10 @@ int pos_visit(int atom, int *next, int max_atom,
   return min;
 }
 
-void compute_joint_sccs(OCCTAB *occtab, int max_atom)
+int compute_joint_sccs(OCCTAB *occtab, int max_atom, FILE *err)
 {
   int next = 0;           /* Next free component number */
+  int errors = 0;         /* Components extending to several modules */
   ASTACK *stack = NULL;   /* Global stack to be used by visit */
   OCCTAB *scan = NULL;
 
@@ -655,13 +853,305 @@ void compute_joint_sccs(OCCTAB *occtab, int max_atom)
       OCCURRENCES *h = &(scan->ashead)[i];
 
       if(h->visited == 0)
-	pos_visit(atom, &next, max_atom, &stack, occtab);
+	pos_visit(atom, &next, max_atom, &stack, occtab, err, &errors);
     }
 
     scan = scan->next;
   }
 
+  return errors;
+}
+
+
+
+/* ---- Analysis of equivalent atoms (due to rules of the form a :- b.) ---- */
+
+int is_copy_rule(RULE *r)
+{
+  return r->type == TYPE_BASIC && get_pos_cnt(r) == 1 && get_neg_cnt(r) == 0;
+}
+
+int eq_visit(int atom, int *next, int max_atom,
+	     ASTACK **stack, OCCTAB *occtab)
+{
+  OCCURRENCES *h = find_occurrences(occtab, atom);
+  int min = ++(*next);
+  int i = 0;
+
+  h->visited = min;
+
+  *stack = push(atom, 0, NULL, *stack);
+
+  /* Traverse atoms that imply this one by a single rule */
+
+  for(i=0; i < h->rule_cnt; i++) {
+    RULE *r = h->rules[i];
+
+    if(is_copy_rule(r)) {
+      int atom2 = get_pos(r)[0];
+      OCCURRENCES *h2 = find_occurrences(occtab, atom2);
+      int rvalue = h2->visited;
+
+      if(h2->status & MARK_INPUT)
+	continue;
+
+      if(rvalue == 0)
+	rvalue = eq_visit(atom2, next, max_atom, stack, occtab);
+
+      if(rvalue < min) min = rvalue;
+    }
+  }
+
+  /* Unwind a SCC (a class of equivalent atoms) from the stack */
+
+  if(h->visited == min) {
+    int size = count_on(*stack, atom)+1;
+    int atom2 = 0;
+
+    *stack = pop(&atom2, NULL, NULL, *stack);
+
+    h->scc = min;
+    h->scc_size = size;
+    h->visited = max_atom+1;
+
+    while(atom2 != atom) {
+      OCCURRENCES *h2 = find_occurrences(occtab, atom2);
+
+      h2->scc = min;
+      h2->scc_size = size;
+      h2->visited = max_atom+1;
+
+      *stack = pop(&atom2, NULL, NULL, *stack);
+    }
+  }
+
+  return min;
+}
+
+void compute_equivalences(OCCTAB *occtab, int max_atom)
+{
+  int next = 0;           /* Next free component number */
+  ASTACK *stack = NULL;   /* Global stack to be used by eq_visit */
+  OCCTAB *scan = NULL;
+
+  /* Visit all atoms except input atoms */
+
+  scan = occtab;
+
+  while(scan) {
+    int count = scan->count;
+    int offset = scan->offset;
+    int i = 0;
+
+    for(i=1; i<=count; i++) {
+      int atom = i+offset;
+      OCCURRENCES *h = &(scan->ashead)[i];
+
+      if(!(h->status & MARK_INPUT) && h->visited == 0)
+	eq_visit(atom, &next, max_atom, &stack, occtab);
+    }
+
+    scan = scan->next;
+  }
+
+  merge_copied_atoms(occtab, max_atom);
+
+  return;
+}
+
+/* An atom a defined by a single rule a :- b. is equivalent to b even if
+   no cycle is involved, unless a or b is an input atom or a appears in
+   the compute statement. Such chains are acyclic outside nontrivial
+   classes, and their atoms join the class at the end of the chain. */
+
+void merge_copied_atoms(OCCTAB *occtab, int max_atom)
+{
+  int *body = (int *)calloc(max_atom+1, sizeof(int));
+  int *size = (int *)calloc(max_atom+2, sizeof(int));
+  OCCTAB *scan = occtab;
+  int atom = 0;
+
+  while(scan) {
+    int count = scan->count;
+    int offset = scan->offset;
+    int *statuses = scan->atoms->statuses;
+    int i = 0;
+
+    for(i=1; i<=count; i++) {
+      OCCURRENCES *h = &(scan->ashead)[i];
+
+      if(h->scc_size == 1 && h->rule_cnt == 1
+	 && !(h->status & MARK_INPUT)
+	 && !(statuses[i] & MARK_TRUE_OR_FALSE)
+	 && is_copy_rule(h->rules[0])) {
+	int atom2 = get_pos(h->rules[0])[0];
+
+	if(atom2 != i+offset
+	   && !(find_occurrences(occtab, atom2)->status & MARK_INPUT))
+	  body[i+offset] = atom2;
+      }
+    }
+
+    scan = scan->next;
+  }
+
+  /* Resolve the end of each chain and compress the path to it */
+
+  for(atom=1; atom<=max_atom; atom++) {
+    int root = atom;
+    int next = atom;
+
+    while(body[root])
+      root = body[root];
+
+    while(body[next]) {
+      int atom2 = body[next];
+
+      body[next] = root;
+      next = atom2;
+    }
+  }
+
+  for(atom=1; atom<=max_atom; atom++)
+    if(body[atom])
+      find_occurrences(occtab, atom)->scc =
+	find_occurrences(occtab, body[atom])->scc;
+
+  /* Recount the sizes of classes */
+
+  for(atom=1; atom<=max_atom; atom++) {
+    OCCURRENCES *h = find_occurrences(occtab, atom);
+
+    if(h->scc)
+      size[h->scc]++;
+  }
+
+  for(atom=1; atom<=max_atom; atom++) {
+    OCCURRENCES *h = find_occurrences(occtab, atom);
+
+    if(h->scc)
+      h->scc_size = size[h->scc];
+  }
+
+  free(body);
+  free(size);
+
   return;
 }
 
+/* ------ Topological order of SCCs (iterative version of Tarjan's) ------- */
+
+int next_dependency(OCCURRENCES *h, int *rpos, int *lpos)
+{
+  /* Positive and negative body atoms of defining rules in order */
+
+  while(*rpos < h->rule_cnt) {
+    RULE *r = h->rules[*rpos];
+    int pos_cnt = get_pos_cnt(r);
+    int neg_cnt = get_neg_cnt(r);
+
+    if(*lpos < pos_cnt)
+      return get_pos(r)[(*lpos)++];
+    else if(*lpos < pos_cnt+neg_cnt) {
+      (*lpos)++;
+      return get_neg(r)[*lpos-pos_cnt-1];
+    }
+
+    (*rpos)++;
+    *lpos = 0;
+  }
+
+  return 0;
+}
+
+int compute_scc_order(OCCTAB *occtab, int max_atom, int *order)
+{
+  int next = 0;                                     /* Next free number */
+  int cnt = 0;                                      /* Atoms in order */
+  int *low = (int *)calloc(max_atom+1, sizeof(int));
+  int *stack = (int *)malloc((max_atom+1)*sizeof(int));
+  int *calls = (int *)malloc((max_atom+1)*sizeof(int));
+  int *rpos = (int *)malloc((max_atom+1)*sizeof(int));
+  int *lpos = (int *)malloc((max_atom+1)*sizeof(int));
+  int top = 0;                                      /* Top of stack */
+  int depth = 0;                                    /* Top of calls */
+  OCCTAB *scan = occtab;
+
+  /* Atoms are appended to order as their SCCs are completed so that
+     atoms depended on precede the atoms depending on them */
+
+  while(scan) {
+    int count = scan->count;
+    int offset = scan->offset;
+    int i = 0;
+
+    for(i=1; i<=count; i++) {
+      int atom = i+offset;
+
+      if((scan->ashead)[i].visited)
+	continue;
+
+      (scan->ashead)[i].visited = low[atom] = ++next;
+      stack[top++] = atom;
+      calls[depth] = atom;
+      rpos[depth] = lpos[depth] = 0;
+      depth++;
+
+      while(depth) {
+	int v = calls[depth-1];
+	OCCURRENCES *h = find_occurrences(occtab, v);
+	int w = next_dependency(h, &rpos[depth-1], &lpos[depth-1]);
+
+	if(w) {
+	  OCCURRENCES *h2 = find_occurrences(occtab, w);
+
+	  if(h2->visited == 0) {
+	    h2->visited = low[w] = ++next;
+	    stack[top++] = w;
+	    calls[depth] = w;
+	    rpos[depth] = lpos[depth] = 0;
+	    depth++;
+	  } else if(h2->visited <= max_atom && h2->visited < low[v])
+	    low[v] = h2->visited;     /* Still on the stack */
+
+	  continue;
+	}
+
+	/* All dependencies processed: unwind a SCC from the stack */
+
+	if(low[v] == h->visited) {
+	  int first = cnt;
+	  int scc = h->visited;
+	  int atom2 = 0;
+
+	  do {
+	    atom2 = stack[--top];
+	    order[cnt++] = atom2;
+	  } while(atom2 != v);
+
+	  for(atom2=first; atom2<cnt; atom2++) {
+	    OCCURRENCES *h2 = find_occurrences(occtab, order[atom2]);
+
+	    h2->scc = scc;
+	    h2->scc_size = cnt-first;
+	    h2->visited = max_atom+1;
+	  }
+	}
 
+	depth--;
+	if(depth && low[v] < low[calls[depth-1]])
+	  low[calls[depth-1]] = low[v];
+      }
+    }
+
+    scan = scan->next;
+  }
+
+  free(low);
+  free(stack);
+  free(calls);
+  free(rpos);
+  free(lpos);
+
+  return cnt;
+}
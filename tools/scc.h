@@ -29,11 +29,22 @@
 
 extern void _version_scc_c();
 
+/* Body occurrences: rules are numbered in the order of the program */
+
+typedef struct bodyocc {
+  int rule;             /* Number of the rule */
+  int index;            /* Position of the literal in the body */
+} BODYOCC;
+
 /* Defining rules */
 
 typedef struct occurrences {
   int rule_cnt;         /* Number of rules */
   RULE **rules;         /* First rule */
+  int pos_cnt;          /* Number of positive body occurrences */
+  BODYOCC *posbody;     /* Positive body occurrences (if computed) */
+  int neg_cnt;          /* Number of negative body occurrences */
+  BODYOCC *negbody;     /* Negative body occurrences (if computed) */
   int scc;              /* Number of the strongly connected component */
   int scc_size;         /* Size of the srongly connected component */
   int visited;          /* For Tarjan's algorithm */
@@ -53,8 +64,17 @@ typedef struct occtab {
 
 extern OCCTAB *initialize_occurrences(ATAB *table);
 extern OCCTAB *append_occurrences(OCCTAB *table, OCCTAB *occurrences);
+extern void free_occurrences(OCCTAB *occtab);
 extern void compute_occurrences(RULE *program, OCCTAB *occtab, int prune);
+extern int compute_body_occurrences(RULE *program, OCCTAB *occtab);
 extern OCCURRENCES *find_occurrences(OCCTAB *occtab, int atom);
 extern void compute_sccs(OCCTAB *occtable, int max_atom, int control);
-extern void compute_joint_sccs(OCCTAB *occtab, int max_atom);
+extern void compute_positive_occurrences(RULE *program, OCCTAB *occtab);
+extern void compute_sccs_from(OCCTAB *occtab, int max_atom, int cnt,
+			      int *atoms, int control);
+extern void reset_sccs(OCCTAB *occtab);
+extern int compute_joint_sccs(OCCTAB *occtab, int max_atom, FILE *err);
+extern void compute_equivalences(OCCTAB *occtab, int max_atom);
+extern void merge_copied_atoms(OCCTAB *occtab, int max_atom);
+extern int compute_scc_order(OCCTAB *occtab, int max_atom, int *order);
 extern int is_stratifiable(OCCTAB *occtab);
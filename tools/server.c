@@ -0,0 +1,366 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Link server over a Unix domain socket (lpcat -d)
+ *
+ * (c) 2026 Tomi Janhunen
+ *
+ * The main thread accepts connections and queues them for a pool of
+ * worker threads, each of which serves one session at a time. Reading
+ * requests and writing replies proceed concurrently, but calls to liblp
+ * are serialized by link_lock since its symbol table is global.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "version.h"
+#include "symbol.h"
+#include "atom.h"
+#include "rule.h"
+#include "normalize.h"
+#include "linker.h"
+#include "server.h"
+
+void _version_server_c()
+{
+  _version("$RCSfile: server.c,v $",
+	   "$Date: 2026/10/18 21:00:00 $",
+	   "$Revision: 1.1 $");
+}
+
+pthread_mutex_t link_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Queue of accepted connections */
+
+typedef struct connqueue {
+  int *fds;
+  int size;
+  int first;
+  int cnt;
+  pthread_mutex_t lock;
+  pthread_cond_t nonempty;
+} CONNQUEUE;
+
+typedef struct session {
+  LINKER *linker;
+  int flags;
+  int first_atom;
+  FILE *in;
+  FILE *out;
+} SESSION;
+
+typedef struct serverpool {
+  CONNQUEUE queue;
+  int flags;
+  int first_atom;
+} SERVERPOOL;
+
+/* ------------------------- Replies --------------------------------------- */
+
+void reply_error(SESSION *s, const char *message)
+{
+  fprintf(s->out, "ERROR %s\n", message);
+  fflush(s->out);
+
+  return;
+}
+
+void reply_count(SESSION *s, long n)
+{
+  fprintf(s->out, "OK %li\n", n);
+  fflush(s->out);
+
+  return;
+}
+
+void reply_data(SESSION *s, char *buf, size_t len)
+{
+  fprintf(s->out, "OK %lu\n", (unsigned long)len);
+  fwrite(buf, 1, len, s->out);
+  fflush(s->out);
+
+  return;
+}
+
+/* ------------------------- Requests -------------------------------------- */
+
+int reset_session(SESSION *s)
+{
+  pthread_mutex_lock(&link_lock);
+  free_linker(s->linker);
+  s->linker = new_linker(s->flags | LINK_COLLECT, s->first_atom);
+  pthread_mutex_unlock(&link_lock);
+
+  return s->linker ? 0 : -1;
+}
+
+void serve_module(SESSION *s, long len)
+{
+  char *buf = NULL;
+  int status = 0;
+  int atoms = 0;
+
+  if(len <= 0 || len > SERVER_MODULE_MAX) {
+    reply_error(s, "invalid module size");
+    return;
+  }
+
+  /* Receive the module before taking the lock */
+
+  if((buf = (char *)malloc(len)) == NULL) {
+    reply_error(s, "cannot allocate memory");
+    return;
+  }
+  if(fread(buf, 1, len, s->in) != (size_t)len) {
+    free(buf);
+    return;   /* The client has gone */
+  }
+
+  pthread_mutex_lock(&link_lock);
+  status = link_buffer(s->linker, buf, len);
+  atoms = linked_atom_count(s->linker);
+  pthread_mutex_unlock(&link_lock);
+
+  free(buf);
+
+  if(status == LINK_OK)
+    reply_count(s, atoms);
+  else
+    reply_error(s, linker_error(s->linker));
+
+  return;
+}
+
+void serve_symbols(SESSION *s)
+{
+  char *buf = NULL;
+  size_t len = 0;
+  FILE *out = open_memstream(&buf, &len);
+  int status = LINK_ERROR_OUTPUT;
+
+  if(out) {
+    pthread_mutex_lock(&link_lock);
+    status = write_linked_symbols(s->linker, out);
+    pthread_mutex_unlock(&link_lock);
+    fclose(out);
+  }
+
+  if(status == LINK_OK)
+    reply_data(s, buf, len);
+  else
+    reply_error(s, out ? linker_error(s->linker) : "cannot allocate memory");
+  free(buf);
+
+  return;
+}
+
+void serve_finalize(SESSION *s)
+{
+  char *buf = NULL;
+  size_t len = 0;
+  int status = 0;
+
+  pthread_mutex_lock(&link_lock);
+  status = finalize_into_buffer(s->linker, &buf, &len);
+  pthread_mutex_unlock(&link_lock);
+
+  if(status == LINK_OK)
+    reply_data(s, buf, len);
+  else
+    reply_error(s, linker_error(s->linker));
+  free(buf);
+
+  return;
+}
+
+void serve_session(int fd, int flags, int first_atom)
+{
+  SESSION session;
+  char line[SERVER_LINE_MAX];
+  int fd2 = dup(fd);
+  long n = 0;
+
+  session.linker = NULL;
+  session.flags = flags;
+  session.first_atom = first_atom;
+  session.in = fdopen(fd, "r");
+  session.out = fd2 < 0 ? NULL : fdopen(fd2, "w");
+
+  if(!session.in || !session.out || reset_session(&session)) {
+    if(session.in) fclose(session.in); else close(fd);
+    if(session.out) fclose(session.out); else if(fd2 >= 0) close(fd2);
+    return;
+  }
+
+  while(fgets(line, SERVER_LINE_MAX, session.in)) {
+    if(sscanf(line, "MODULE %li", &n) == 1)
+      serve_module(&session, n);
+    else if(strcmp(line, "ATOMS\n") == 0) {
+      pthread_mutex_lock(&link_lock);
+      n = linked_atom_count(session.linker);
+      pthread_mutex_unlock(&link_lock);
+      reply_count(&session, n);
+    } else if(strcmp(line, "SYMBOLS\n") == 0)
+      serve_symbols(&session);
+    else if(strcmp(line, "FINALIZE\n") == 0)
+      serve_finalize(&session);
+    else if(strcmp(line, "RESET\n") == 0) {
+      if(reset_session(&session))
+	break;
+      reply_count(&session, 0);
+    } else if(strcmp(line, "QUIT\n") == 0) {
+      reply_count(&session, 0);
+      break;
+    } else
+      reply_error(&session, "unknown request");
+  }
+
+  pthread_mutex_lock(&link_lock);
+  free_linker(session.linker);
+  pthread_mutex_unlock(&link_lock);
+
+  fclose(session.in);
+  fclose(session.out);
+
+  return;
+}
+
+/* ------------------------- Thread pool ----------------------------------- */
+
+void enqueue_connection(CONNQUEUE *q, int fd)
+{
+  pthread_mutex_lock(&q->lock);
+
+  if(q->cnt == q->size) {  /* Grow and straighten the circular buffer */
+    int *fds = (int *)malloc(2*q->size*sizeof(int));
+    int i = 0;
+
+    if(!fds) {
+      pthread_mutex_unlock(&q->lock);
+      close(fd);
+      return;
+    }
+    for(i=0; i<q->cnt; i++)
+      fds[i] = q->fds[(q->first+i) % q->size];
+    free(q->fds);
+    q->fds = fds;
+    q->first = 0;
+    q->size *= 2;
+  }
+
+  q->fds[(q->first+q->cnt) % q->size] = fd;
+  q->cnt++;
+
+  pthread_cond_signal(&q->nonempty);
+  pthread_mutex_unlock(&q->lock);
+
+  return;
+}
+
+int dequeue_connection(CONNQUEUE *q)
+{
+  int fd = 0;
+
+  pthread_mutex_lock(&q->lock);
+  while(q->cnt == 0)
+    pthread_cond_wait(&q->nonempty, &q->lock);
+
+  fd = q->fds[q->first];
+  q->first = (q->first+1) % q->size;
+  q->cnt--;
+  pthread_mutex_unlock(&q->lock);
+
+  return fd;
+}
+
+void *session_worker(void *arg)
+{
+  SERVERPOOL *pool = (SERVERPOOL *)arg;
+
+  while(1)
+    serve_session(dequeue_connection(&pool->queue),
+		  pool->flags, pool->first_atom);
+
+  return NULL;
+}
+
+/*
+ * serve_links -- Serve link sessions on the socket path until killed
+ */
+
+void serve_links(char *path, int threads, int flags, int first_atom)
+{
+  SERVERPOOL pool;
+  struct sockaddr_un addr;
+  pthread_t thread;
+  int listener = 0;
+  int i = 0;
+
+  if(strlen(path) >= sizeof(addr.sun_path)) {
+    fprintf(stderr, "%s: socket path %s is too long\n", program_name, path);
+    exit(-1);
+  }
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  unlink(path);
+
+  if((listener = socket(AF_UNIX, SOCK_STREAM, 0)) < 0 ||
+     bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+     listen(listener, SERVER_QUEUE) < 0) {
+    fprintf(stderr, "%s: cannot listen on socket %s\n", program_name, path);
+    exit(-1);
+  }
+
+  signal(SIGPIPE, SIG_IGN);  /* Clients may leave at any time */
+
+  pool.queue.size = SERVER_QUEUE;
+  pool.queue.fds = (int *)malloc(pool.queue.size*sizeof(int));
+  pool.queue.first = 0;
+  pool.queue.cnt = 0;
+  pthread_mutex_init(&pool.queue.lock, NULL);
+  pthread_cond_init(&pool.queue.nonempty, NULL);
+  pool.flags = flags;
+  pool.first_atom = first_atom;
+
+  for(i=0; i<threads; i++)
+    if(pthread_create(&thread, NULL, session_worker, &pool)) {
+      fprintf(stderr, "%s: cannot create a thread\n", program_name);
+      exit(-1);
+    } else
+      pthread_detach(thread);
+
+  while(1) {
+    int fd = accept(listener, NULL, NULL);
+
+    if(fd >= 0)
+      enqueue_connection(&pool.queue, fd);
+  }
+}
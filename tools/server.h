@@ -0,0 +1,55 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Link server over a Unix domain socket (lpcat -d)
+ *
+ * (c) 2026 Tomi Janhunen
+ *
+ * Each connection is a link session with a linker of its own. Requests
+ * are lines, and each is answered by "OK <n>\n" or "ERROR <message>\n":
+ *
+ *   MODULE <bytes>  -- the given number of bytes follow and are linked as
+ *                      one or more modules; <n> is the number of atoms
+ *   ATOMS           -- <n> is the number of atoms linked so far
+ *   SYMBOLS         -- <n> bytes of the symbol section follow
+ *   FINALIZE        -- <n> bytes of the linked program follow; the
+ *                      session accepts no further modules
+ *   RESET           -- start over with an empty linker
+ *   QUIT            -- end the session (as does closing the connection)
+ *
+ * Sessions share the symbol table of liblp, which only grows: the memory
+ * of the server is proportional to the number of distinct atom names
+ * seen over its lifetime, so long-running servers should be restarted
+ * when fed with ever new names.
+ */
+
+/* Version information */
+
+#define _SERVER_H_RCSFILE  "$RCSfile: server.h,v $"
+#define _SERVER_H_DATE     "$Date: 2026/10/18 21:00:00 $"
+#define _SERVER_H_REVISION "$Revision: 1.1 $"
+
+extern void _version_server_c();
+
+#define SERVER_LINE_MAX   256        /* Length of request lines */
+#define SERVER_MODULE_MAX (1<<30)    /* Bytes in a single MODULE request */
+#define SERVER_QUEUE      64         /* Backlog of pending connections */
+
+extern void serve_links(char *path, int threads, int flags, int first_atom);
@@ -0,0 +1,188 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+/*
+ * Sharing of rule bodies: rules whose bodies consist of the same
+ * literals are mapped to a single BODY record (hash-consing)
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "version.h"
+#include "symbol.h"
+#include "atom.h"
+#include "rule.h"
+#include "normalize.h"
+#include "share.h"
+
+void _version_share_h()
+{
+  _version(_SHARE_H_RCSFILE, _SHARE_H_DATE, _SHARE_H_REVISION);
+}
+
+void _version_share_c()
+{
+  _version_share_h();
+  _version("$RCSfile: share.c,v $",
+	   "$Date: 2026/10/18 17:00:00 $",
+	   "$Revision: 1.1 $");
+}
+
+BODYTAB *new_body_table(int cnt)
+{
+  BODYTAB *bodies = (BODYTAB *)malloc(sizeof(BODYTAB));
+  int size = 16;
+
+  while(size < cnt)
+    size *= 2;
+
+  bodies->size = size;
+  bodies->count = 0;
+  bodies->buckets = (BODY **)calloc(size, sizeof(BODY *));
+  bodies->scratch = NULL;
+  bodies->scratch_size = 0;
+
+  return bodies;
+}
+
+/* Sort and remove duplicates from a list of atoms */
+
+int canonical_atom_list(int cnt, int *atoms)
+{
+  int i = 0, j = 0;
+
+  sort_atom_list(cnt, atoms);
+
+  for(i=0; i<cnt; i++)
+    if(j == 0 || atoms[j-1] != atoms[i])
+      atoms[j++] = atoms[i];
+
+  return j;
+}
+
+unsigned int hash_body(int pos_cnt, int neg_cnt, int *atoms)
+{
+  unsigned int hash = 2166136261u;
+  int i = 0;
+
+  for(i=0; i<pos_cnt+neg_cnt; i++)
+    hash = (hash ^ (unsigned int)atoms[i]) * 16777619u;
+
+  return hash ^ (unsigned int)pos_cnt;
+}
+
+/*
+ * lookup_body -- Find the body of a rule and add it if create is set; the
+ * body is made canonical in the scratch area of the table
+ */
+
+BODY *lookup_body(BODYTAB *bodies, RULE *rule, int create)
+{
+  int pos_cnt = get_pos_cnt(rule);
+  int neg_cnt = get_neg_cnt(rule);
+  int *atoms = NULL;
+  unsigned int hash = 0;
+  BODY *body = NULL;
+
+  if(pos_cnt+neg_cnt > bodies->scratch_size) {
+    bodies->scratch_size = 2*(pos_cnt+neg_cnt);
+    bodies->scratch = (int *)realloc(bodies->scratch,
+				     bodies->scratch_size*sizeof(int));
+  }
+  atoms = bodies->scratch;
+
+  memcpy(atoms, get_pos(rule), pos_cnt*sizeof(int));
+  pos_cnt = canonical_atom_list(pos_cnt, atoms);
+  memcpy(&atoms[pos_cnt], get_neg(rule), neg_cnt*sizeof(int));
+  neg_cnt = canonical_atom_list(neg_cnt, &atoms[pos_cnt]);
+
+  hash = hash_body(pos_cnt, neg_cnt, atoms);
+
+  for(body = bodies->buckets[hash & (bodies->size-1)]; body;
+      body = body->next)
+    if(body->hash == hash
+       && body->pos_cnt == pos_cnt && body->neg_cnt == neg_cnt
+       && memcmp(body->atoms, atoms, (pos_cnt+neg_cnt)*sizeof(int)) == 0)
+      break;
+
+  if(body || !create)
+    return body;
+
+  body = (BODY *)malloc(sizeof(BODY));
+  body->pos_cnt = pos_cnt;
+  body->neg_cnt = neg_cnt;
+  body->atoms = (int *)malloc((pos_cnt+neg_cnt+1)*sizeof(int));
+  memcpy(body->atoms, atoms, (pos_cnt+neg_cnt)*sizeof(int));
+  body->hash = hash;
+  body->uses = 0;
+  body->saved = 0;
+  body->atom = 0;
+  body->first = rule;
+  body->next = bodies->buckets[hash & (bodies->size-1)];
+  bodies->buckets[hash & (bodies->size-1)] = body;
+  bodies->count++;
+
+  return body;
+}
+
+BODY *share_body(BODYTAB *bodies, RULE *rule)
+{
+  return lookup_body(bodies, rule, -1);
+}
+
+BODY *find_body(BODYTAB *bodies, RULE *rule)
+{
+  return lookup_body(bodies, rule, 0);
+}
+
+void free_body_table(BODYTAB *bodies)
+{
+  int i = 0;
+
+  for(i=0; i<bodies->size; i++) {
+    BODY *body = bodies->buckets[i];
+
+    while(body) {
+      BODY *next = body->next;
+
+      free(body->atoms);
+      free(body);
+      body = next;
+    }
+  }
+
+  free(bodies->buckets);
+  free(bodies->scratch);
+  free(bodies);
+
+  return;
+}
+
+void write_share_stats(FILE *out, SHARESTATS *stats)
+{
+  fprintf(out, "%s: %i bodies shared by %i rules\n", program_name,
+	  stats->bodies, stats->rules);
+
+  return;
+}
@@ -0,0 +1,70 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+/*
+ * Sharing of rule bodies (hash-consing of canonical bodies)
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+/* Version information */
+
+#define _SHARE_H_RCSFILE  "$RCSfile: share.h,v $"
+#define _SHARE_H_DATE     "$Date: 2026/10/18 17:00:00 $"
+#define _SHARE_H_REVISION "$Revision: 1.1 $"
+
+extern void _version_share_c();
+
+/* Canonical bodies: sorted positive atoms followed by sorted negative ones */
+
+typedef struct body {
+  int pos_cnt;
+  int neg_cnt;
+  int *atoms;
+  unsigned int hash;
+  int uses;             /* Number of rules having this body */
+  int saved;            /* Literals saved if an atom stands for the body */
+  int atom;             /* The atom standing for the body (0 if none) */
+  RULE *first;          /* The first rule having this body */
+  struct body *next;    /* Next body in the same bucket */
+} BODY;
+
+typedef struct bodytab {
+  int size;             /* Number of buckets (a power of two) */
+  int count;            /* Number of bodies */
+  BODY **buckets;
+  int *scratch;         /* The canonical body under lookup */
+  int scratch_size;
+} BODYTAB;
+
+/* Statistics on sharing */
+
+typedef struct sharestats {
+  int bodies;           /* Number of bodies given an atom */
+  int rules;            /* Number of rules having such bodies */
+} SHARESTATS;
+
+/* Utilities */
+
+extern BODYTAB *new_body_table(int cnt);
+extern BODY *share_body(BODYTAB *bodies, RULE *rule);
+extern BODY *find_body(BODYTAB *bodies, RULE *rule);
+extern void free_body_table(BODYTAB *bodies);
+extern void write_share_stats(FILE *out, SHARESTATS *stats);
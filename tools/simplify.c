@@ -0,0 +1,781 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Simplification of programs using (an approximation of) the
+ * well-founded model: atoms derivable from facts are made true and
+ * atoms without potential support (unfounded atoms) are made false
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "version.h"
+#include "symbol.h"
+#include "atom.h"
+#include "rule.h"
+#include "io.h"
+#include "scc.h"
+#include "simplify.h"
+
+void _version_simplify_h()
+{
+  _version(_SIMPLIFY_H_RCSFILE, _SIMPLIFY_H_DATE, _SIMPLIFY_H_REVISION);
+}
+
+void _version_simplify_c()
+{
+  _version_simplify_h();
+  _version("$RCSfile: simplify.c,v $",
+	   "$Date: 2026/10/18 12:00:00 $",
+	   "$Revision: 1.1 $");
+}
+
+#define VALUE_UNKNOWN 0
+#define VALUE_TRUE 1
+#define VALUE_FALSE 2
+
+#define RULE_FIRED 1
+#define RULE_BLOCKED 2
+
+/* Bodies are treated uniformly as weighted literal lists with a bound:
+   a rule fires once the weight of satisfied literals reaches the bound
+   (need <= 0) and it is blocked once the falsified literals make this
+   impossible (slack < 0) */
+
+typedef struct wfstate {
+  int rule_cnt;         /* Number of rules */
+  RULE **rules;         /* Rules by number */
+  int *need;            /* Weight still needed to fire a rule */
+  int *slack;           /* Weight that may still be falsified */
+  int *flags;           /* RULE_FIRED and RULE_BLOCKED */
+  int max_atom;         /* Largest atom number */
+  int *value;           /* Truth values of atoms */
+  int *support;         /* Number of unblocked defining rules */
+  int *stack;           /* Atoms whose values are to be propagated */
+  int top;              /* Top of the stack */
+  OCCTAB *occtab;       /* Head and body occurrences */
+  int conflict;         /* An atom has become both true and false */
+} WFSTATE;
+
+/* ----------------------- Access to rule structures ----------------------- */
+
+int rule_heads(RULE *rule, int **heads)
+{
+  switch(rule->type) {
+  case TYPE_BASIC:
+    *heads = &(rule->data.basic->head);
+    return 1;
+
+  case TYPE_CONSTRAINT:
+    *heads = &(rule->data.constraint->head);
+    return 1;
+
+  case TYPE_WEIGHT:
+    *heads = &(rule->data.weight->head);
+    return 1;
+
+  case TYPE_CHOICE:
+    *heads = rule->data.choice->head;
+    return rule->data.choice->head_cnt;
+
+  case TYPE_DISJUNCTIVE:
+    *heads = rule->data.disjunctive->head;
+    return rule->data.disjunctive->head_cnt;
+
+  default:
+    *heads = NULL;
+  }
+
+  return 0;
+}
+
+int rule_bound(RULE *rule, int **weights)
+{
+  *weights = NULL;
+
+  switch(rule->type) {
+  case TYPE_CONSTRAINT:
+    return rule->data.constraint->bound;
+
+  case TYPE_WEIGHT:
+    *weights = rule->data.weight->weight;
+    return rule->data.weight->bound;
+
+  case TYPE_OPTIMIZE:
+    *weights = rule->data.optimize->weight;
+    return 0;
+
+  default:
+    return get_pos_cnt(rule) + get_neg_cnt(rule);
+  }
+}
+
+int literal_weight(RULE *rule, int index, int positive)
+{
+  int *weights = NULL;
+
+  rule_bound(rule, &weights);
+
+  if(!weights)
+    return 1;
+  else if(positive)
+    return weights[get_neg_cnt(rule) + index];
+  else
+    return weights[index];
+}
+
+/* ------------------------- Propagation of values ------------------------- */
+
+void set_value(WFSTATE *state, int atom, int value)
+{
+  int *current = &(state->value)[atom];
+
+  if(*current == value)
+    return;
+
+  if(*current != VALUE_UNKNOWN) {
+    state->conflict = -1;
+    return;
+  }
+
+  *current = value;
+  state->stack[state->top++] = atom;
+
+  return;
+}
+
+void fire_rule(WFSTATE *state, int number)
+{
+  RULE *rule = state->rules[number];
+  int *heads = NULL;
+  int head_cnt = rule_heads(rule, &heads);
+
+  state->flags[number] |= RULE_FIRED;
+
+  /* Choice rules and proper disjunctions do not force their heads */
+
+  if(head_cnt == 1 && rule->type != TYPE_CHOICE)
+    set_value(state, heads[0], VALUE_TRUE);
+
+  return;
+}
+
+void block_rule(WFSTATE *state, int number)
+{
+  RULE *rule = state->rules[number];
+  int *heads = NULL;
+  int head_cnt = rule_heads(rule, &heads);
+  int i = 0;
+
+  state->flags[number] |= RULE_BLOCKED;
+
+  for(i=0; i<head_cnt; i++) {
+    int atom = heads[i];
+    OCCURRENCES *h = find_occurrences(state->occtab, atom);
+
+    if(--(state->support)[atom] == 0 && !(h->status & MARK_INPUT))
+      set_value(state, atom, VALUE_FALSE);
+  }
+
+  return;
+}
+
+void satisfy_literal(WFSTATE *state, int number, int weight)
+{
+  if(state->flags[number] & (RULE_FIRED | RULE_BLOCKED))
+    return;
+
+  if((state->need[number] -= weight) <= 0)
+    fire_rule(state, number);
+
+  return;
+}
+
+void falsify_literal(WFSTATE *state, int number, int weight)
+{
+  if(state->flags[number] & RULE_BLOCKED)
+    return;
+
+  if((state->slack[number] -= weight) < 0)
+    block_rule(state, number);
+
+  return;
+}
+
+void propagate(WFSTATE *state)
+{
+  while(state->top && !state->conflict) {
+    int atom = state->stack[--(state->top)];
+    int value = state->value[atom];
+    OCCURRENCES *h = find_occurrences(state->occtab, atom);
+    int i = 0;
+
+    for(i=0; i<h->pos_cnt; i++) {
+      BODYOCC *b = &(h->posbody)[i];
+      int weight = literal_weight(state->rules[b->rule], b->index, -1);
+
+      if(value == VALUE_TRUE)
+	satisfy_literal(state, b->rule, weight);
+      else
+	falsify_literal(state, b->rule, weight);
+    }
+
+    for(i=0; i<h->neg_cnt; i++) {
+      BODYOCC *b = &(h->negbody)[i];
+      int weight = literal_weight(state->rules[b->rule], b->index, 0);
+
+      if(value == VALUE_TRUE)
+	falsify_literal(state, b->rule, weight);
+      else
+	satisfy_literal(state, b->rule, weight);
+    }
+  }
+
+  return;
+}
+
+/* ----------- Detection of unfounded atoms (including loops) ------------- */
+
+void make_possible(int atom, int *possible, int *stack, int *top)
+{
+  if(!possible[atom]) {
+    possible[atom] = -1;
+    stack[(*top)++] = atom;
+  }
+
+  return;
+}
+
+void make_heads_possible(RULE *rule, int *possible, int *stack, int *top)
+{
+  int *heads = NULL;
+  int head_cnt = rule_heads(rule, &heads);
+  int i = 0;
+
+  for(i=0; i<head_cnt; i++)
+    make_possible(heads[i], possible, stack, top);
+
+  return;
+}
+
+int unfounded_atoms(WFSTATE *state)
+{
+  int max_atom = state->max_atom;
+  int *possible = (int *)calloc(max_atom+1, sizeof(int));
+  int *pneed = (int *)malloc((state->rule_cnt+1)*sizeof(int));
+  int *stack = (int *)malloc((max_atom+1)*sizeof(int));
+  int top = 0;
+  int count = 0;
+  int i = 0;
+
+  /* The least set of atoms derivable by rules that are not blocked
+     when negative literals are satisfied unless their atoms are true */
+
+  for(i=0; i<state->rule_cnt; i++) {
+    RULE *rule = state->rules[i];
+    int neg_cnt = get_neg_cnt(rule);
+    int *neg = get_neg(rule);
+    int *weights = NULL;
+    int j = 0;
+
+    pneed[i] = rule_bound(rule, &weights);
+
+    for(j=0; j<neg_cnt; j++)
+      if(state->value[neg[j]] != VALUE_TRUE)
+	pneed[i] -= literal_weight(rule, j, 0);
+
+    if(!(state->flags[i] & RULE_BLOCKED) && pneed[i] <= 0)
+      make_heads_possible(rule, possible, stack, &top);
+  }
+
+  for(i=1; i<=max_atom; i++) {
+    OCCURRENCES *h = find_occurrences(state->occtab, i);
+
+    if(h && (state->value[i] == VALUE_TRUE || (h->status & MARK_INPUT)))
+      make_possible(i, possible, stack, &top);
+  }
+
+  while(top) {
+    int atom = stack[--top];
+    OCCURRENCES *h = find_occurrences(state->occtab, atom);
+
+    for(i=0; i<h->pos_cnt; i++) {
+      BODYOCC *b = &(h->posbody)[i];
+      RULE *rule = state->rules[b->rule];
+
+      if(state->flags[b->rule] & RULE_BLOCKED)
+	continue;
+
+      if(pneed[b->rule] > 0 &&
+	 (pneed[b->rule] -= literal_weight(rule, b->index, -1)) <= 0)
+	make_heads_possible(rule, possible, stack, &top);
+    }
+  }
+
+  /* Atoms that remain impossible are false */
+
+  for(i=1; i<=max_atom; i++) {
+    OCCURRENCES *h = find_occurrences(state->occtab, i);
+
+    if(h && !possible[i] && state->value[i] == VALUE_UNKNOWN
+       && !(h->status & MARK_INPUT)) {
+      set_value(state, i, VALUE_FALSE);
+      count++;
+    }
+  }
+
+  free(possible);
+  free(pneed);
+  free(stack);
+
+  return count;
+}
+
+/* ------------------------ Rewriting of the rules ------------------------- */
+
+int remove_decided(int cnt, int *atoms, int *weights, int positive,
+		   WFSTATE *state, int *satisfied, SIMPSTATS *stats)
+{
+  int i = 0, j = 0;
+
+  for(i=0; i<cnt; i++) {
+    int value = state->value[atoms[i]];
+    int weight = weights ? weights[i] : 1;
+
+    if(value == VALUE_UNKNOWN) {
+      atoms[j] = atoms[i];
+      if(weights)
+	weights[j] = weights[i];
+      j++;
+    } else {
+      if((value == VALUE_TRUE) == (positive != 0))
+	*satisfied += weight;
+      stats->literals++;
+    }
+  }
+
+  return j;
+}
+
+int remove_decided_heads(int cnt, int *heads, WFSTATE *state,
+			 SIMPSTATS *stats)
+{
+  int i = 0, j = 0;
+
+  for(i=0; i<cnt; i++)
+    if(state->value[heads[i]] == VALUE_UNKNOWN)
+      heads[j++] = heads[i];
+    else
+      stats->literals++;
+
+  return j;
+}
+
+int has_true_head(int cnt, int *heads, WFSTATE *state)
+{
+  int i = 0;
+
+  for(i=0; i<cnt; i++)
+    if(state->value[heads[i]] == VALUE_TRUE)
+      return -1;
+
+  return 0;
+}
+
+/* Remove decided literals from the body; returns the satisfied weight */
+
+int simplify_body(RULE *rule, WFSTATE *state, SIMPSTATS *stats)
+{
+  int *pos_cnt = NULL, *neg_cnt = NULL;
+  int *pos = NULL, *neg = NULL;
+  int *weights = NULL;
+  int satisfied = 0;
+  int old_neg_cnt = 0;
+
+  switch(rule->type) {
+  case TYPE_BASIC:
+    { BASIC_RULE *basic = rule->data.basic;
+      pos_cnt = &basic->pos_cnt; pos = basic->pos;
+      neg_cnt = &basic->neg_cnt; neg = basic->neg;
+    }
+    break;
+
+  case TYPE_CONSTRAINT:
+    { CONSTRAINT_RULE *constraint = rule->data.constraint;
+      pos_cnt = &constraint->pos_cnt; pos = constraint->pos;
+      neg_cnt = &constraint->neg_cnt; neg = constraint->neg;
+    }
+    break;
+
+  case TYPE_CHOICE:
+    { CHOICE_RULE *choice = rule->data.choice;
+      pos_cnt = &choice->pos_cnt; pos = choice->pos;
+      neg_cnt = &choice->neg_cnt; neg = choice->neg;
+    }
+    break;
+
+  case TYPE_INTEGRITY:
+    { INTEGRITY_RULE *integrity = rule->data.integrity;
+      pos_cnt = &integrity->pos_cnt; pos = integrity->pos;
+      neg_cnt = &integrity->neg_cnt; neg = integrity->neg;
+    }
+    break;
+
+  case TYPE_WEIGHT:
+    { WEIGHT_RULE *weight = rule->data.weight;
+      pos_cnt = &weight->pos_cnt; pos = weight->pos;
+      neg_cnt = &weight->neg_cnt; neg = weight->neg;
+      weights = weight->weight;
+    }
+    break;
+
+  case TYPE_OPTIMIZE:
+    { OPTIMIZE_RULE *optimize = rule->data.optimize;
+      pos_cnt = &optimize->pos_cnt; pos = optimize->pos;
+      neg_cnt = &optimize->neg_cnt; neg = optimize->neg;
+      weights = optimize->weight;
+    }
+    break;
+
+  case TYPE_DISJUNCTIVE:
+    { DISJUNCTIVE_RULE *disjunctive = rule->data.disjunctive;
+      pos_cnt = &disjunctive->pos_cnt; pos = disjunctive->pos;
+      neg_cnt = &disjunctive->neg_cnt; neg = disjunctive->neg;
+    }
+    break;
+
+  default:
+    error("unknown rule type");
+  }
+
+  /* Weights of negative literals precede those of positive ones */
+
+  old_neg_cnt = *neg_cnt;
+  *neg_cnt = remove_decided(*neg_cnt, neg, weights, 0,
+			    state, &satisfied, stats);
+  *pos_cnt = remove_decided(*pos_cnt, pos,
+			    weights ? &weights[old_neg_cnt] : NULL, -1,
+			    state, &satisfied, stats);
+  if(weights && *neg_cnt < old_neg_cnt)
+    memmove(&weights[*neg_cnt], &weights[old_neg_cnt],
+	    (*pos_cnt)*sizeof(int));
+
+  return satisfied;
+}
+
+/* Returns zero if the rule can be removed altogether */
+
+int simplify_rule(int number, WFSTATE *state, SIMPSTATS *stats)
+{
+  RULE *rule = state->rules[number];
+  int *heads = NULL;
+  int head_cnt = rule_heads(rule, &heads);
+  int satisfied = 0;
+
+  if(state->flags[number] & RULE_BLOCKED)
+    return 0;
+
+  switch(rule->type) {
+  case TYPE_BASIC:
+  case TYPE_CONSTRAINT:
+  case TYPE_WEIGHT:
+    if(state->value[heads[0]] != VALUE_UNKNOWN)
+      return 0;
+    break;
+
+  case TYPE_CHOICE:
+    { CHOICE_RULE *choice = rule->data.choice;
+
+      choice->head_cnt = remove_decided_heads(head_cnt, heads, state, stats);
+      if(choice->head_cnt == 0)
+	return 0;
+    }
+    break;
+
+  case TYPE_DISJUNCTIVE:
+    { DISJUNCTIVE_RULE *disjunctive = rule->data.disjunctive;
+
+      /* The rule is satisfied by the facts that are kept */
+
+      if(has_true_head(head_cnt, heads, state))
+	return 0;
+
+      disjunctive->head_cnt =
+	remove_decided_heads(head_cnt, heads, state, stats);
+      if(disjunctive->head_cnt == 0)
+	return 0;
+    }
+    break;
+  }
+
+  satisfied = simplify_body(rule, state, stats);
+
+  if(rule->type == TYPE_CONSTRAINT)
+    rule->data.constraint->bound -= satisfied;
+  else if(rule->type == TYPE_WEIGHT)
+    rule->data.weight->bound -= satisfied;
+
+  return -1;
+}
+
+int *atom_status(ATAB *table, int atom)
+{
+  while(table) {
+    int count = table->count;
+    int offset = table->offset;
+
+    if(atom > offset && atom <= offset+count)
+      return &(table->statuses)[atom-offset];
+
+    table = table->next;
+  }
+
+  return NULL;
+}
+
+RULE *new_fact(int atom)
+{
+  RULE *rule = (RULE *)malloc(sizeof(RULE));
+  BASIC_RULE *basic = (BASIC_RULE *)malloc(sizeof(BASIC_RULE));
+
+  basic->head = atom;
+  basic->pos_cnt = 0;
+  basic->pos = NULL;
+  basic->neg_cnt = 0;
+  basic->neg = NULL;
+
+  rule->type = TYPE_BASIC;
+  rule->data.basic = basic;
+  rule->next = NULL;
+
+  return rule;
+}
+
+/* Rewrite the program; true atoms that are visible or appear in the
+   compute statement are kept as facts while the rest disappear */
+
+RULE *rewrite_program(WFSTATE *state, ATAB *table, SIMPSTATS *stats)
+{
+  RULE *program = NULL;
+  RULE *last = NULL;
+  RULE *dropped = NULL;
+  int i = 0;
+
+  for(i=1; i<=state->max_atom; i++) {
+    OCCURRENCES *h = find_occurrences(state->occtab, i);
+    int *status = atom_status(table, i);
+
+    if(!h)
+      continue;
+
+    if(state->value[i] == VALUE_TRUE) {
+      stats->true_atoms++;
+
+      if((h->status & (MARK_VISIBLE | MARK_INPUT)) ||
+	 (*status & MARK_TRUE_OR_FALSE)) {
+	RULE *fact = new_fact(i);
+
+	if(last)
+	  last->next = fact;
+	else
+	  program = fact;
+	last = fact;
+
+	if(h->status & MARK_VISIBLE)
+	  *status |= MARK_TRUE;
+      }
+    } else if(state->value[i] == VALUE_FALSE) {
+      stats->false_atoms++;
+
+      if(h->status & MARK_VISIBLE)
+	*status |= MARK_FALSE;
+    }
+  }
+
+  for(i=0; i<state->rule_cnt; i++) {
+    RULE *rule = state->rules[i];
+
+    if(simplify_rule(i, state, stats)) {
+      if(last)
+	last->next = rule;
+      else
+	program = rule;
+      last = rule;
+    } else {
+      rule->next = dropped;
+      dropped = rule;
+      stats->removed++;
+    }
+  }
+
+  if(last)
+    last->next = NULL;
+
+  if(dropped)
+    free_program(dropped);
+
+  return program;
+}
+
+/* ----------------------- Simplification of programs ---------------------- */
+
+/* The compute statement must agree with the decided atoms; otherwise
+   there are no answer sets (decided atoms are dropped by rewriting) */
+
+int violates_compute_statement(WFSTATE *state, ATAB *table)
+{
+  int i = 0;
+
+  for(i=1; i<=state->max_atom; i++) {
+    int *status = atom_status(table, i);
+
+    if(!status)
+      continue;
+
+    if(state->value[i] == VALUE_FALSE && (*status & MARK_TRUE))
+      return -1;
+    if(state->value[i] == VALUE_TRUE && (*status & MARK_FALSE))
+      return -1;
+  }
+
+  return 0;
+}
+
+RULE *simplify_program(RULE *program, ATAB *table, SIMPSTATS *stats)
+{
+  WFSTATE state;
+  RULE *rule = NULL;
+  int max_atom = table_size(table);
+  int i = 0;
+
+  state.occtab = initialize_occurrences(table);
+  compute_occurrences(program, state.occtab, 0);
+  state.rule_cnt = compute_body_occurrences(program, state.occtab);
+
+  state.rules = (RULE **)malloc((state.rule_cnt+1)*sizeof(RULE *));
+  state.need = (int *)malloc((state.rule_cnt+1)*sizeof(int));
+  state.slack = (int *)malloc((state.rule_cnt+1)*sizeof(int));
+  state.flags = (int *)calloc(state.rule_cnt+1, sizeof(int));
+  state.max_atom = max_atom;
+  state.value = (int *)calloc(max_atom+1, sizeof(int));
+  state.support = (int *)calloc(max_atom+1, sizeof(int));
+  state.stack = (int *)malloc((max_atom+1)*sizeof(int));
+  state.top = 0;
+  state.conflict = 0;
+
+  for(rule = program, i = 0; rule; rule = rule->next, i++)
+    state.rules[i] = rule;
+
+  for(i=1; i<=max_atom; i++) {
+    OCCURRENCES *h = find_occurrences(state.occtab, i);
+
+    if(h)
+      state.support[i] = h->rule_cnt;
+  }
+
+  /* Initialize counters and process facts and impossible bodies */
+
+  for(i=0; i<state.rule_cnt; i++) {
+    int *weights = NULL;
+    int bound = 0;
+    int total = 0;
+    int j = 0;
+
+    rule = state.rules[i];
+    bound = rule_bound(rule, &weights);
+    total = get_pos_cnt(rule) + get_neg_cnt(rule);
+
+    if(weights)
+      for(j=0, total=0; j<get_pos_cnt(rule)+get_neg_cnt(rule); j++)
+	total += weights[j];
+
+    state.need[i] = bound;
+    state.slack[i] = total - bound;
+
+    if(rule->type == TYPE_OPTIMIZE)
+      continue;
+
+    if(state.slack[i] < 0)
+      block_rule(&state, i);
+    else if(state.need[i] <= 0)
+      fire_rule(&state, i);
+  }
+
+  for(i=1; i<=max_atom; i++) {
+    OCCURRENCES *h = find_occurrences(state.occtab, i);
+
+    if(h && state.support[i] == 0 && !(h->status & MARK_INPUT))
+      set_value(&state, i, VALUE_FALSE);
+  }
+
+  /* Alternate between propagation and unfounded sets: propagation is
+     linear in the size of the program over all rounds, but each round
+     recomputes unfounded atoms from scratch, so the total time is
+     O(rounds x |P|) where the number of rounds is at most the number
+     of atoms (typically a few) */
+
+  propagate(&state);
+
+  while(!state.conflict && unfounded_atoms(&state)) {
+    stats->rounds++;
+    propagate(&state);
+  }
+
+  stats->rules += state.rule_cnt;
+
+  if(!state.conflict && violates_compute_statement(&state, table))
+    state.conflict = -1;
+
+  if(state.conflict)
+    stats->conflict = -1;
+  else
+    program = rewrite_program(&state, table, stats);
+
+  free(state.rules);
+  free(state.need);
+  free(state.slack);
+  free(state.flags);
+  free(state.value);
+  free(state.support);
+  free(state.stack);
+  free_occurrences(state.occtab);
+
+  return program;
+}
+
+void write_simplification_stats(FILE *out, SIMPSTATS *stats)
+{
+  if(stats->conflict) {
+    fprintf(out, "%s: simplification: the program has no answer sets!\n",
+	    program_name);
+    return;
+  }
+
+  fprintf(out, "%s: simplified %i rules: ", program_name, stats->rules);
+  fprintf(out, "%i rules and %i literals removed, ",
+	  stats->removed, stats->literals);
+  fprintf(out, "%i true and %i false atoms (%i rounds)\n",
+	  stats->true_atoms, stats->false_atoms, stats->rounds);
+
+  return;
+}
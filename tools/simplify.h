@@ -0,0 +1,49 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Simplification of programs using the well-founded model
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+/* Version information */
+
+#define _SIMPLIFY_H_RCSFILE  "$RCSfile: simplify.h,v $"
+#define _SIMPLIFY_H_DATE     "$Date: 2026/10/18 12:00:00 $"
+#define _SIMPLIFY_H_REVISION "$Revision: 1.1 $"
+
+extern void _version_simplify_c();
+
+/* Statistics on simplification */
+
+typedef struct simpstats {
+  int rules;            /* Number of rules processed */
+  int removed;          /* Number of rules removed */
+  int literals;         /* Number of decided literals removed */
+  int true_atoms;       /* Number of atoms found true */
+  int false_atoms;      /* Number of atoms found false */
+  int rounds;           /* Number of rounds for unfounded sets */
+  int conflict;         /* Contradiction detected (no answer sets) */
+} SIMPSTATS;
+
+/* Utilities */
+
+extern RULE *simplify_program(RULE *program, ATAB *table, SIMPSTATS *stats);
+extern void write_simplification_stats(FILE *out, SIMPSTATS *stats);
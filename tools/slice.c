@@ -0,0 +1,250 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Slicing of programs: only rules in the dependency cone of query atoms,
+ * the compute statement, and minimize statements are kept. The cone is
+ * closed under positive and negative dependencies as well as head atoms
+ * shared by rules, i.e., it forms a splitting set for the program.
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "version.h"
+#include "symbol.h"
+#include "atom.h"
+#include "rule.h"
+#include "io.h"
+#include "scc.h"
+#include "slice.h"
+
+void _version_slice_h()
+{
+  _version(_SLICE_H_RCSFILE, _SLICE_H_DATE, _SLICE_H_REVISION);
+}
+
+void _version_slice_c()
+{
+  _version_slice_h();
+  _version("$RCSfile: slice.c,v $",
+	   "$Date: 2026/10/18 15:00:00 $",
+	   "$Revision: 1.1 $");
+}
+
+/* ------------------------- Reading query atoms -------------------------- */
+
+char **read_query(FILE *in, int *cnt)
+{
+  int size = 16;
+  char **names = (char **)malloc(size*sizeof(char *));
+  char *name = NULL;
+
+  *cnt = 0;
+
+  while(!feof(in) && (name = read_string(in))) {
+    if(*cnt == size) {
+      size *= 2;
+      names = (char **)realloc(names, size*sizeof(char *));
+    }
+    names[(*cnt)++] = name;
+    fscanf(in, "\n");
+  }
+
+  return names;
+}
+
+int compare_names(const void *n1, const void *n2)
+{
+  return strcmp(*(char * const *)n1, *(char * const *)n2);
+}
+
+/* --------------------- Backward reachability of atoms -------------------- */
+
+void add_to_cone(int atom, int offset, int *incone, int *stack, int *top)
+{
+  if(!incone[atom-offset]) {
+    incone[atom-offset] = -1;
+    stack[(*top)++] = atom;
+  }
+
+  return;
+}
+
+void add_list_to_cone(int cnt, int *atoms, int offset,
+		      int *incone, int *stack, int *top)
+{
+  int i = 0;
+
+  for(i=0; i<cnt; i++)
+    add_to_cone(atoms[i], offset, incone, stack, top);
+
+  return;
+}
+
+int in_cone(RULE *rule, int offset, int *incone)
+{
+  int *heads = NULL;
+  int head_cnt = 0;
+  int i = 0;
+
+  if(rule->type == TYPE_OPTIMIZE || rule->type == TYPE_INTEGRITY)
+    return -1;
+
+  heads = get_heads(rule);
+  head_cnt = get_head_cnt(rule);
+
+  for(i=0; i<head_cnt; i++)
+    if(incone[heads[i]-offset])
+      return -1;
+
+  return 0;
+}
+
+RULE *slice_program(RULE *program, ATAB *table,
+		    int cnt, char **names, SLICESTATS *stats)
+{
+  OCCTAB *occtab = NULL;
+  int count = 0;
+  int offset = 0;
+  int *incone = NULL;
+  int *stack = NULL;
+  int top = 0;
+  RULE *rule = NULL;
+  RULE *last = NULL;
+  RULE *dropped = NULL;
+  int i = 0;
+
+  if(!table || table->next) {
+    fprintf(stderr, "%s: contiguous symbol table expected!\n",
+	    program_name);
+    exit(-1);
+  }
+
+  count = table->count;
+  offset = table->offset;
+
+  occtab = initialize_occurrences(table);
+  compute_occurrences(program, occtab, 0);
+
+  incone = (int *)calloc(count+1, sizeof(int));
+  stack = (int *)malloc((count+1)*sizeof(int));
+
+  /* Seeds: query atoms, the compute statement, and atoms whose
+     values are constrained regardless of any query */
+
+  qsort(names, cnt, sizeof(char *), compare_names);
+
+  for(i=1; i<=count; i++) {
+    SYMBOL *sym = table->names[i];
+
+    if(sym && cnt &&
+       bsearch(&(sym->name), names, cnt, sizeof(char *), compare_names)) {
+      add_to_cone(i+offset, offset, incone, stack, &top);
+      stats->queries++;
+    }
+
+    if(table->statuses[i] & MARK_TRUE_OR_FALSE)
+      add_to_cone(i+offset, offset, incone, stack, &top);
+  }
+
+  for(rule = program; rule; rule = rule->next)
+    if(rule->type == TYPE_OPTIMIZE || rule->type == TYPE_INTEGRITY) {
+      add_list_to_cone(get_pos_cnt(rule), get_pos(rule), offset,
+		       incone, stack, &top);
+      add_list_to_cone(get_neg_cnt(rule), get_neg(rule), offset,
+		       incone, stack, &top);
+    }
+
+  /* Traverse defining rules backwards */
+
+  while(top) {
+    int atom = stack[--top];
+    OCCURRENCES *h = &(occtab->ashead)[atom-offset];
+
+    for(i=0; i<h->rule_cnt; i++) {
+      RULE *r = h->rules[i];
+
+      add_list_to_cone(get_head_cnt(r), get_heads(r), offset,
+		       incone, stack, &top);
+      add_list_to_cone(get_pos_cnt(r), get_pos(r), offset,
+		       incone, stack, &top);
+      add_list_to_cone(get_neg_cnt(r), get_neg(r), offset,
+		       incone, stack, &top);
+    }
+  }
+
+  /* Keep the rules in the cone and forget other atoms */
+
+  rule = program;
+  program = NULL;
+
+  while(rule) {
+    RULE *next = rule->next;
+
+    stats->rules++;
+
+    if(in_cone(rule, offset, incone)) {
+      if(last)
+	last->next = rule;
+      else
+	program = rule;
+      last = rule;
+      stats->kept++;
+    } else {
+      rule->next = dropped;
+      dropped = rule;
+    }
+
+    rule = next;
+  }
+
+  if(last)
+    last->next = NULL;
+
+  if(dropped)
+    free_program(dropped);
+
+  for(i=1; i<=count; i++)
+    if(incone[i])
+      stats->atoms++;
+    else {
+      table->names[i] = NULL;
+      table->statuses[i] &= ~(MARK_VISIBLE | MARK_INPUT);
+    }
+
+  free(incone);
+  free(stack);
+  free_occurrences(occtab);
+
+  return program;
+}
+
+void write_slicing_stats(FILE *out, SLICESTATS *stats)
+{
+  fprintf(out, "%s: sliced for %i query atoms: ", program_name,
+	  stats->queries);
+  fprintf(out, "%i atoms and %i out of %i rules kept\n",
+	  stats->atoms, stats->kept, stats->rules);
+
+  return;
+}
@@ -0,0 +1,48 @@
+/* asptools -- Tool collection for answer set programming
+
+   Copyright (C) 2022 Tomi Janhunen
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+/*
+ * Slicing of programs with respect to query atoms
+ *
+ * (c) 2026 Tomi Janhunen
+ */
+
+/* Version information */
+
+#define _SLICE_H_RCSFILE  "$RCSfile: slice.h,v $"
+#define _SLICE_H_DATE     "$Date: 2026/10/18 15:00:00 $"
+#define _SLICE_H_REVISION "$Revision: 1.1 $"
+
+extern void _version_slice_c();
+
+/* Statistics on slicing */
+
+typedef struct slicestats {
+  int queries;          /* Number of query atoms found */
+  int atoms;            /* Number of atoms in the cone */
+  int rules;            /* Number of rules processed */
+  int kept;             /* Number of rules in the cone */
+} SLICESTATS;
+
+/* Utilities */
+
+extern char **read_query(FILE *in, int *cnt);
+extern RULE *slice_program(RULE *program, ATAB *table,
+			   int cnt, char **names, SLICESTATS *stats);
+extern void write_slicing_stats(FILE *out, SLICESTATS *stats);